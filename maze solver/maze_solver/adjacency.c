@@ -0,0 +1,69 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program holds the pieces shared by the junction graph and the HPA* abstraction while they
+ * are built: a growable list of integers to collect nodes and edges in, and the conversion of
+ * the collected edge lists into compressed sparse row (CSR) adjacency arrays.
+*/
+
+#include <stdlib.h>
+
+#include "adjacency.h"
+
+int list_push(struct int_list *l, int v) {
+    if (l->size == l->cap) {
+        size_t cap = l->cap ? l->cap * 2 : 256;
+        int *data = realloc(l->data, sizeof(int) * cap);
+        if (data == NULL) return 1;
+        l->data = data;
+        l->cap = cap;
+    }
+    l->data[l->size++] = v;
+    return 0;
+}
+
+/**
+ * Stores the edge from 'u' to 'v' with label 'label' at the insert position of 'u', which
+ * then moves on by one.
+ *
+ * start, node, node_label: adjacency arrays under construction.
+ * u, v: ends of the edge.
+ * label: label of the edge.
+*/
+static void place(int *start, int *node, int *node_label, int u, int v, int label) {
+    node[start[u]] = v;
+    node_label[start[u]++] = label;
+}
+
+int adjacency_build(int n_nodes, int n_edges, const int *from, const int *to, const int *label,
+                    bool both_ways, int **start, int **node, int **node_label) {
+    size_t n_entries = (size_t) n_edges * (both_ways ? 2 : 1) + 1;
+    int *s = *start = calloc((size_t) n_nodes + 1, sizeof(int));
+    int *nd = *node = malloc(sizeof(int) * n_entries);
+    int *nl = *node_label = malloc(sizeof(int) * n_entries);
+    if (!s || !nd || !nl) return 1;
+
+    for (int e = 0; e < n_edges; e++) {
+        s[from[e] + 1]++;
+        if (both_ways) s[to[e] + 1]++;
+    }
+    for (int i = 0; i < n_nodes; i++) {
+        s[i + 1] += s[i];
+    }
+
+    /* Fill using start[i] as insert position, then shift the starts back. */
+    for (int e = 0; e < n_edges; e++) {
+        int l = label ? label[e] : e;
+        place(s, nd, nl, from[e], to[e], l);
+        if (both_ways) place(s, nd, nl, to[e], from[e], l);
+    }
+    for (int i = n_nodes; i > 0; i--) {
+        s[i] = s[i - 1];
+    }
+    s[0] = 0;
+
+    return 0;
+}
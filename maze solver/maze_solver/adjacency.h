@@ -0,0 +1,30 @@
+#ifndef _ADJACENCY_H_
+#define _ADJACENCY_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Growable list of integers used while building a graph. Start it as
+ * { NULL, 0, 0 } and free 'data' when done. */
+struct int_list {
+    int *data;
+    size_t size;
+    size_t cap;
+};
+
+/* Appends 'v' to list 'l', growing it if needed.
+ * Returns 0 if successful, 1 if memory could not be allocated. */
+int list_push(struct int_list *l, int v);
+
+/* Builds the compressed sparse row (CSR) adjacency arrays of a graph with
+ * 'n_nodes' nodes and 'n_edges' edges, where edge e goes from 'from[e]' to
+ * 'to[e]' and carries the label 'label[e]', or e itself if 'label' is NULL.
+ * If 'both_ways' is true every edge is also stored from 'to[e]' to 'from[e]'.
+ * The edges of node i are the entries (*start)[i] up to (*start)[i + 1] of
+ * '*node', the other end, and '*node_label', their labels, all three
+ * allocated here for the caller to free, also when the build fails.
+ * Returns 0 if successful, 1 if memory could not be allocated. */
+int adjacency_build(int n_nodes, int n_edges, const int *from, const int *to, const int *label,
+                    bool both_ways, int **start, int **node, int **node_label);
+
+#endif
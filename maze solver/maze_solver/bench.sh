@@ -0,0 +1,143 @@
+#! /usr/bin/env bash
+
+# Times every solver variant on generated mazes and writes the results as CSV.
+# usage: ./bench.sh [sizes] [repetitions] [output]
+# For every size (odd, default 65 up to 8193) a perfect, a multi-path, an open
+# and an impossible maze are made with ../maze_generator (or $GENERATOR). The
+# generator seeds itself from the clock, so the mazes are generated once and
+# kept in bench_mazes/ with their seeds; later runs reuse them, which keeps
+# the results comparable between commits. Remove the directory, or run make
+# clean, for new mazes.
+# The solvers are built with release flags in a temporary directory, and they
+# and the generator run there, so the out.ppm they write does not replace the
+# one in this directory.
+# Every variant runs 'repetitions' times on every maze with --stats=json; the
+# median and 95th percentile of the search and path reconstruction time it
+# reports, without reading and printing the maze, are given in ns per cell,
+# with the speedup of the median against the plain BFS and DFS. The reps
+# column counts the runs that succeeded; a variant without any is written as
+# failed, with its times and speedups left empty.
+
+set -Eeuo pipefail
+
+SIZES=${1:-65 129 257 513 1025 2049 4097 8193}
+REPS=${2:-5}
+OUT=${3:-bench.csv}
+GENERATOR=$(realpath -m "${GENERATOR:-../maze_generator}")
+MAZES=$PWD/bench_mazes
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+VARIANTS="bfs bfs_prune bfs_bitparallel bfs_bidirectional bfs_threads bfs_external dfs dfs_prune
+          astar astar_jps graph graph_hpa dial lpa"
+
+# Generates a maze of a kind and size in the binary format, with its seed in a
+# .seed file next to it, unless it is there already.
+# usage: make_maze kind size
+make_maze() {
+    local kind=$1 n=$2 maze="$MAZES/$1_$2.mazb"
+    [ -f "$maze" ] && return
+
+    if [ ! -x "$GENERATOR" ]; then
+        echo "$GENERATOR is not executable; make it so or point GENERATOR at a maze generator" >&2
+        exit 1
+    fi
+
+    local p=0
+    [ "$kind" == multi ] && p=0.1
+    [ "$kind" == open ] && p=1
+    # The generator also writes an out.ppm, so it runs in the scratch directory too.
+    if ! (cd "$WORK/run" && "$GENERATOR" "$n" "$p" > "$WORK/maze.txt" 2> "$WORK/gen.log"); then
+        cat "$WORK/gen.log" >&2
+        echo "$GENERATOR failed to make a $kind maze of size $n" >&2
+        exit 1
+    fi
+    grep -o "Seed: [0-9]*" "$WORK/gen.log" | grep -o "[0-9]*$" > "$maze.seed"
+
+    # An impossible maze is a perfect maze with the destination walled in.
+    if [ "$kind" == impossible ]; then
+        awk '{ row[NR] = $0; d = index($0, "D"); if (d) { dr = NR; dc = d } }
+             END { for (i = 1; i <= NR; i++) {
+                       line = row[i]
+                       if (i == dr - 1 || i == dr + 1) line = substr(line, 1, dc - 1) "#" substr(line, dc + 1)
+                       if (i == dr) line = substr(line, 1, dc - 2) "#D#" substr(line, dc + 2)
+                       print line
+                   } }' "$WORK/maze.txt" > "$WORK/walled.txt"
+        mv "$WORK/walled.txt" "$WORK/maze.txt"
+    fi
+    "$WORK/maze_convert" "$maze" < "$WORK/maze.txt"
+}
+
+# Runs a solver variant once on a maze in the scratch directory and prints the
+# measurements it reports as one line of JSON.
+# usage: run variant maze
+run() (
+    local maze=$2
+    cd "$WORK/run"
+    case $1 in
+        bfs) "$WORK/maze_solver_bfs" --stats=json < "$maze" ;;
+        bfs_prune) "$WORK/maze_solver_bfs" --prune --stats=json < "$maze" ;;
+        bfs_bitparallel) "$WORK/maze_solver_bfs" --bitparallel --stats=json < "$maze" ;;
+        bfs_bidirectional) "$WORK/maze_solver_bfs" --bidirectional --stats=json < "$maze" ;;
+        bfs_threads) "$WORK/maze_solver_bfs" --threads 4 --stats=json < "$maze" ;;
+        bfs_external) "$WORK/maze_solver_bfs" --external "$maze" --stats=json ;;
+        dfs) "$WORK/maze_solver_dfs" --stats=json < "$maze" ;;
+        dfs_prune) "$WORK/maze_solver_dfs" --prune --stats=json < "$maze" ;;
+        astar) "$WORK/maze_solver_astar" --stats=json < "$maze" ;;
+        astar_jps) "$WORK/maze_solver_astar" --jps --stats=json < "$maze" ;;
+        graph) "$WORK/maze_solver_graph" --stats=json < "$maze" ;;
+        graph_hpa) "$WORK/maze_solver_graph" --hpa 16 --stats=json < "$maze" ;;
+        dial) "$WORK/maze_solver_dial" --stats=json < "$maze" ;;
+        lpa) "$WORK/maze_replan" --stats=json < "$maze" ;;
+    esac 2>&1 > /dev/null | grep "^{" || true
+)
+
+# Prints the search and reconstruction time in ns and the path length of REPS
+# runs of a variant on a maze, one run per line. A failed run is left out.
+# usage: run_times variant maze
+run_times() {
+    for _ in $(seq "$REPS"); do
+        run "$1" "$2" | awk '{ match($0, /"search_ms": [0-9.]+/); search = substr($0, RSTART + 13, RLENGTH - 13)
+                               match($0, /"reconstruction_ms": [0-9.]+/); path = substr($0, RSTART + 21, RLENGTH - 21)
+                               match($0, /"path_length": [0-9a-z]+/); length_ = substr($0, RSTART + 15, RLENGTH - 15)
+                               printf "%.0f %s\n", (search + path) * 1e6, length_ == "null" ? "none" : length_ }'
+    done
+}
+
+cp ./*.c ./*.h Makefile "$WORK"
+make -C "$WORK" release CFLAGS="-O3 -DNDEBUG" LDFLAGS=-lm > /dev/null
+mkdir -p "$MAZES" "$WORK/run"
+
+echo "kind,size,cells,seed,solver,reps,length,median_ns_per_cell,p95_ns_per_cell,speedup_vs_bfs,speedup_vs_dfs" \
+    > "$OUT"
+for n in $SIZES; do
+    for kind in perfect multi open impossible; do
+        make_maze "$kind" "$n"
+        maze="$MAZES/${kind}_$n.mazb"
+        echo "${kind}_$n" >&2
+
+        # successful runs, median and p95 in ns per cell and path length of every variant
+        declare -A runs=() median=() p95=() length=()
+        for variant in $VARIANTS; do
+            run_times "$variant" "$maze" > "$WORK/times"
+            runs[$variant]=$(wc -l < "$WORK/times")
+            read -r median[$variant] p95[$variant] < <(sort -n "$WORK/times" \
+                | awk -v cells=$(( n * n )) '{ t[NR - 1] = $1 }
+                  END { if (NR) printf "%.3f %.3f\n", t[int(NR / 2)] / cells, t[int(NR * 95 / 100)] / cells
+                        else print "" }')
+            length[$variant]=$(awk 'NR == 1 { print $2 }' "$WORK/times")
+        done
+
+        for variant in $VARIANTS; do
+            # A speedup needs the time of the variant and of the baseline.
+            speedup=$(awk -v m="${median[$variant]}" -v bfs="${median[bfs]}" -v dfs="${median[dfs]}" \
+                      'BEGIN { if (m > 0 && bfs != "") printf "%.2f", bfs / m
+                               printf ","
+                               if (m > 0 && dfs != "") printf "%.2f", dfs / m }')
+            printf "%s,%s,%s,%s,%s,%s,%s,%s,%s,%s\n" "$kind" "$n" $(( n * n )) "$(cat "$maze.seed")" \
+                "$variant" "${runs[$variant]}" "${length[$variant]:-failed}" "${median[$variant]}" \
+                "${p95[$variant]}" "$speedup" >> "$OUT"
+        done
+    done
+done
+echo "results written to $OUT" >&2
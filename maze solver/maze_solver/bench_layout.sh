@@ -0,0 +1,90 @@
+#! /usr/bin/env bash
+
+# Compares the row-major and the tiled cell layout on large mazes.
+# usage: ./bench_layout.sh [mazes..]
+# Without arguments 4097x4097 and 8193x8193 mazes are generated with
+# ../maze_generator (or $GENERATOR). Both layouts are built with release flags
+# in their own temporary directory, and the solvers and the generator run in
+# another one, so the out.ppm they write does not replace the one in this
+# directory.
+# For every maze and layout the best of RUNS search times of the BFS and DFS
+# solvers, as reported by --stats=json, is printed with their cache misses.
+# The misses are counted by perf if it is available, else simulated by
+# valgrind's cachegrind, else by the cache model of make cachesim (see
+# cache_sim.c). The last two print the first level data and the last level
+# misses as D1/LL.
+
+set -Eeuo pipefail
+
+RUNS=3
+GENERATOR=$(realpath -m "${GENERATOR:-../maze_generator}")
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+# Builds a target with a layout in its own directory.
+# usage: build directory target layout
+build() {
+    mkdir "$WORK/$1"
+    cp ./*.c ./*.h Makefile "$WORK/$1"
+    make -C "$WORK/$1" "$2" LAYOUT="$3" > /dev/null
+}
+
+# Prints the best of RUNS search times in ms of a solver on a maze.
+# usage: best_search maze solver
+best_search() {
+    for _ in $(seq "$RUNS"); do
+        (cd "$WORK/run" && "$2" --stats=json < "$1" 2>&1 > /dev/null) \
+            | grep "^{" | grep -o '"search_ms": [0-9.]*' | cut -d' ' -f2 || true
+    done | sort -n | head -n 1
+}
+
+# Prints the cache misses of a run of a solver on a maze.
+# usage: cache_misses maze layout solver
+cache_misses() (
+    local maze=$1 solver="$WORK/$2/maze_solver_$3"
+    cd "$WORK/run"
+    if command -v perf > /dev/null; then
+        perf stat -x, -e cache-misses "$solver" < "$maze" 2>&1 > /dev/null | grep cache-misses | cut -d, -f1
+    elif command -v valgrind > /dev/null; then
+        valgrind --tool=cachegrind --cache-sim=yes --cachegrind-out-file=/dev/null "$solver" \
+            < "$maze" 2>&1 > /dev/null \
+            | awk '/D1  misses/ { gsub(",", "", $4); d1 = $4 } /LLd misses/ { gsub(",", "", $4); ll = $4 }
+                   END { print d1 "/" ll }'
+    else
+        "$WORK/$2_sim/maze_solver_$3" < "$maze" 2>&1 > /dev/null \
+            | awk '/^cachesim:/ { print $4 "/" $7 }'
+    fi
+)
+
+mkdir "$WORK/run"
+mazes=()
+for maze in "$@"; do
+    mazes+=("$(realpath "$maze")")
+done
+if [ ${#mazes[@]} -eq 0 ]; then
+    if [ ! -x "$GENERATOR" ]; then
+        echo "$GENERATOR is not executable; make it so or point GENERATOR at a maze generator" >&2
+        exit 1
+    fi
+    for n in 4097 8193; do
+        (cd "$WORK/run" && "$GENERATOR" "$n" 0.1 > "$WORK/maze_$n.txt" 2> /dev/null)
+        mazes+=("$WORK/maze_$n.txt")
+    done
+fi
+
+for layout in rows tiled; do
+    build "$layout" release "$layout"
+    if ! command -v perf > /dev/null && ! command -v valgrind > /dev/null; then
+        build "${layout}_sim" cachesim "$layout"
+    fi
+done
+
+printf "%-16s %-6s %12s %12s %22s %22s\n" maze layout "bfs search" "dfs search" "bfs misses" "dfs misses"
+for maze in "${mazes[@]}"; do
+    for layout in rows tiled; do
+        printf "%-16s %-6s %9s ms %9s ms %22s %22s\n" "$(basename "$maze")" "$layout" \
+            "$(best_search "$maze" "$WORK/$layout/maze_solver_bfs")" \
+            "$(best_search "$maze" "$WORK/$layout/maze_solver_dfs")" \
+            "$(cache_misses "$maze" "$layout" bfs)" "$(cache_misses "$maze" "$layout" dfs)"
+    done
+done
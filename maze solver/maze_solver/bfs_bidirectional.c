@@ -0,0 +1,194 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program provides a bidirectional Breadth-First Search (BFS) for the maze solver. One
+ * search starts at the start and one at the destination. Every round the side with the smaller
+ * frontier expands one complete level, and the search stops in the level where the two sides
+ * meet. On open mazes both searches only cover a disc of about half the path length, instead
+ * of the whole disc around the start that a single BFS explores.
+ *
+ * Every explored cell stores its depth with the sign telling which side found it: positive for
+ * the start side, negative for the destination side. The path is spliced together from the
+ * predecessors of both sides at the meeting edge.
+*/
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "bfs_bidirectional.h"
+#include "queue.h"
+
+struct side {
+    struct queue *q;
+    int sign;
+    int depth;
+};
+
+/* Frontier of both sides, for the measurements. */
+static size_t frontier(const struct side *a, const struct side *b) {
+    return queue_size(a->q) + queue_size(b->q);
+}
+
+struct meeting {
+    int best;
+    int from;
+    int to;
+};
+
+/**
+ * Expands one complete level of a side. When a neighbor already belongs to the other side, the
+ * length of the path through that edge is compared with the best meeting found so far. The whole
+ * level is expanded so the shortest of those paths is found.
+ *
+ * m: maze.
+ * s: side to expand.
+ * depth: signed depth + 1 of every explored cell, 0 if unexplored.
+ * prev: predecessor of every explored cell on its own side.
+ * meet: best meeting edge so far.
+ * other: the other side, only read for the measurements.
+ * mt: measurements, or NULL. A cell counts at its depth on its own side.
+ *
+ * Returns:
+ * 0 if successful, 1 if the queue or the level histogram could not grow.
+*/
+static int expand_level(struct maze *m, struct side *s, int *depth, int *prev, struct meeting *meet,
+                        const struct side *other, struct metrics *mt) {
+    size_t level_size = queue_size(s->q);
+
+    for (size_t n = 0; n < level_size; n++) {
+        if (mt && metrics_expand(mt, s->depth, frontier(s, other))) return 1;
+        int cur = queue_pop(s->q);
+        int r = maze_row(m, cur);
+        int c = maze_col(m, cur);
+        unsigned open = maze_open_neighbors(m, r, c);
+
+        if (!maze_at_start(m, r, c) && !maze_at_destination(m, r, c)) {
+            maze_set(m, r, c, VISITED);
+        }
+
+        for (int i = 0; i < N_MOVES; i++) {
+            if (!((open >> i) & 1)) continue;
+
+            int r_new = r + m_offsets[i][0];
+            int c_new = c + m_offsets[i][1];
+            if (!maze_valid_move(m, r_new, c_new)) continue;
+
+            int idx = maze_index(m, r_new, c_new);
+            if (depth[idx] == 0) {
+                if (queue_push(s->q, idx)) return 1;
+                depth[idx] = s->sign * (s->depth + 2);
+                prev[idx] = cur;
+                maze_set(m, r_new, c_new, TO_VISIT);
+            } else if ((depth[idx] > 0) != (s->sign > 0)) {
+                int len = s->depth + 1 + abs(depth[idx]) - 1;
+                if (len < meet->best) {
+                    meet->best = len;
+                    meet->from = s->sign > 0 ? cur : idx;
+                    meet->to = s->sign > 0 ? idx : cur;
+                }
+            }
+        }
+    }
+    s->depth++;
+
+    return 0;
+}
+
+/**
+ * Draws the path between the two cells of the meeting edge. The start side is followed back to
+ * the start and the destination side forward to the destination.
+ *
+ * m: maze
+ * prev: predecessor of every explored cell on its own side.
+ * meet: the meeting edge.
+*/
+static void splice_path(struct maze *m, const int *prev, const struct meeting *meet) {
+    int idx = meet->from;
+    while (!maze_at_start(m, maze_row(m, idx), maze_col(m, idx))) {
+        maze_set(m, maze_row(m, idx), maze_col(m, idx), PATH);
+        idx = prev[idx];
+    }
+
+    idx = meet->to;
+    while (!maze_at_destination(m, maze_row(m, idx), maze_col(m, idx))) {
+        maze_set(m, maze_row(m, idx), maze_col(m, idx), PATH);
+        idx = prev[idx];
+    }
+    maze_set(m, maze_row(m, idx), maze_col(m, idx), PATH);
+}
+
+/**
+ * Runs both searches until they meet or one side runs out of cells.
+ *
+ * m: maze
+ * depth: zeroed array for the signed depths of the cells.
+ * prev: array for the predecessors of the cells.
+ * from_start: empty side for the search from the start.
+ * from_dest: empty side for the search from the destination.
+ * mt: measurements, or NULL.
+ *
+ * Returns:
+ * the length of the path if a path is found, NOT_FOUND or ERROR otherwise.
+*/
+static int search(struct maze *m, int *depth, int *prev, struct side *from_start,
+                  struct side *from_dest, struct metrics *mt) {
+    struct meeting meet = { INT_MAX, -1, -1 };
+    int r = 0, c = 0;
+
+    maze_start(m, &r, &c);
+    int start = maze_index(m, r, c);
+    maze_destination(m, &r, &c);
+    int dest = maze_index(m, r, c);
+
+    if (start == dest) return 0;
+
+    depth[start] = 1;
+    depth[dest] = -1;
+    queue_push(from_start->q, start);
+    queue_push(from_dest->q, dest);
+
+    while (meet.best == INT_MAX && !queue_empty(from_start->q) && !queue_empty(from_dest->q)) {
+        struct side *s = from_start, *other = from_dest;
+        if (queue_size(from_dest->q) < queue_size(from_start->q)) {
+            s = from_dest;
+            other = from_start;
+        }
+
+        if (expand_level(m, s, depth, prev, &meet, other, mt)) return ERROR;
+    }
+
+    if (meet.best == INT_MAX) return NOT_FOUND;
+
+    double t0 = metrics_now_ms();
+    splice_path(m, prev, &meet);
+    if (mt) {
+        mt->path_ms = metrics_now_ms() - t0;
+    }
+    return meet.best;
+}
+
+int bfs_bidirectional_solve(struct maze *m, struct metrics *mt) {
+    size_t cells = maze_cells(m);
+    int *depth = calloc(cells, sizeof(int));
+    int *prev = malloc(cells * sizeof(int));
+    struct side from_start = { queue_init((size_t) maze_size(m)), 1, 0 };
+    struct side from_dest = { queue_init((size_t) maze_size(m)), -1, 0 };
+    int len = ERROR;
+
+    if (depth && prev && from_start.q && from_dest.q) {
+        len = search(m, depth, prev, &from_start, &from_dest, mt);
+    }
+    if (mt) {
+        mt->bytes = 2 * sizeof(int) * cells + queue_bytes(from_start.q) + queue_bytes(from_dest.q);
+    }
+
+    queue_cleanup(from_start.q);
+    queue_cleanup(from_dest.q);
+    free(depth);
+    free(prev);
+    return len;
+}
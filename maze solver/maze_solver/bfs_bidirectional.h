@@ -0,0 +1,17 @@
+#ifndef _BFS_BIDIRECTIONAL_H_
+#define _BFS_BIDIRECTIONAL_H_
+
+#include "maze.h"
+#include "metrics.h"
+#include "solver.h"
+
+/* Solves the maze 'm' with two breadth-first searches, one from the start and
+ * one from the destination, that stop as soon as their frontiers meet. The
+ * shortest path is marked with PATH and the explored cells with VISITED.
+ * If 'mt' is not NULL the search is measured into it; the levels of both
+ * searches are counted together by their distance from their own end.
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occured. */
+int bfs_bidirectional_solve(struct maze *m, struct metrics *mt);
+
+#endif
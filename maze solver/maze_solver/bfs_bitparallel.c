@@ -0,0 +1,316 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program provides a bit-parallel Breadth-First Search (BFS) for the maze solver. The
+ * frontier, the open cells and the explored cells are bitsets with the same row-aligned 64-bit
+ * word layout as the walls of the maze, so a single shift, AND or OR on a word advances the
+ * wavefront for 64 cells at once. Only the words that hold frontier cells and the words next to
+ * them are looked at for every level, which keeps the total work linear in the number of cells
+ * even for long winding mazes.
+ *
+ * The distance of a cell is not stored, only its level modulo 3 in two extra bit planes. Two
+ * neighboring cells are at most one level apart, so walking back from the destination to any
+ * explored neighbor whose level is one lower (modulo 3) always follows a shortest path.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bfs_bitparallel.h"
+
+#define WORD_BITS 64
+#define N_PLANES 6
+
+struct flood {
+    int n;
+    size_t stride;
+    size_t words;
+    uint64_t *open;
+    uint64_t *seen;
+    uint64_t *front;
+    uint64_t *next;
+    uint64_t *lvl_lo;
+    uint64_t *lvl_hi;
+    size_t *active;
+    size_t *new_active;
+    size_t *cand;
+    unsigned char *queued;
+};
+
+/**
+ * Frees all memory of the flood fill.
+ *
+ * f: flood fill state.
+*/
+static void flood_cleanup(struct flood *f) {
+    free(f->open);
+    free(f->active);
+    free(f->new_active);
+    free(f->cand);
+    free(f->queued);
+}
+
+/**
+ * Allocates the bit planes and word lists and fills the open plane from the walls of the maze.
+ * The border of the maze is never a valid move, so it is left out of the open plane.
+ *
+ * f: flood fill state.
+ * m: maze.
+ *
+ * Returns:
+ * 0 if successful, 1 if memory could not be allocated.
+*/
+static int flood_init(struct flood *f, const struct maze *m) {
+    f->n = maze_size(m);
+    f->stride = (size_t) maze_stride(m);
+    f->words = f->stride * (size_t) f->n;
+
+    f->open = calloc(N_PLANES * f->words, sizeof(uint64_t));
+    f->active = malloc(f->words * sizeof(size_t));
+    f->new_active = malloc(f->words * sizeof(size_t));
+    f->cand = malloc(f->words * sizeof(size_t));
+    f->queued = calloc(f->words, sizeof(unsigned char));
+    if (!f->open || !f->active || !f->new_active || !f->cand || !f->queued) {
+        flood_cleanup(f);
+        return 1;
+    }
+
+    f->seen = f->open + f->words;
+    f->front = f->seen + f->words;
+    f->next = f->front + f->words;
+    f->lvl_lo = f->next + f->words;
+    f->lvl_hi = f->lvl_lo + f->words;
+
+    const uint64_t *walls = maze_walls(m);
+    for (int r = 1; r < f->n - 1; r++) {
+        uint64_t *row = f->open + (size_t) r * f->stride;
+        for (size_t w = 0; w < f->stride; w++) {
+            row[w] = ~walls[(size_t) r * f->stride + w];
+        }
+        row[0] &= ~(uint64_t) 1;
+        row[(f->n - 1) / WORD_BITS] &= ~((uint64_t) 1 << ((f->n - 1) % WORD_BITS));
+    }
+
+    return 0;
+}
+
+/* Returns the word of 'plane' that holds (r, c). */
+static size_t word_id(const struct flood *f, int r, int c) {
+    return (size_t) r * f->stride + (size_t) (c / WORD_BITS);
+}
+
+/* Returns true if the bit of (r, c) is set in 'plane'. */
+static bool test_bit(const struct flood *f, const uint64_t *plane, int r, int c) {
+    return (plane[word_id(f, r, c)] >> (c % WORD_BITS)) & 1;
+}
+
+/* Returns the level modulo 3 of the explored cell (r, c). */
+static int level_mod3(const struct flood *f, int r, int c) {
+    if (test_bit(f, f->lvl_lo, r, c)) return 1;
+    if (test_bit(f, f->lvl_hi, r, c)) return 2;
+    return 0;
+}
+
+/**
+ * Adds word 't' to the list of words to expand, unless it is already on it.
+ *
+ * f: flood fill state.
+ * t: word index.
+ * n_cand: number of words on the list, updated when 't' is added.
+*/
+static void add_candidate(struct flood *f, size_t t, size_t *n_cand) {
+    if (!f->queued[t]) {
+        f->queued[t] = 1;
+        f->cand[(*n_cand)++] = t;
+    }
+}
+
+/**
+ * Advances the wavefront by one level. Every frontier word can only reach itself and the words
+ * left, right, above and below it, so only those are recomputed. A cell joins the next frontier
+ * if it is open, not explored yet and next to a frontier cell.
+ *
+ * f: flood fill state.
+ * n_active: number of words in 'active' that hold frontier cells.
+ * level: level of the cells that are found in this step.
+ *
+ * Returns:
+ * the number of words that hold cells of the new frontier.
+*/
+static size_t expand_level(struct flood *f, size_t n_active, int level) {
+    size_t n_cand = 0;
+
+    for (size_t i = 0; i < n_active; i++) {
+        size_t id = f->active[i];
+        size_t w = id % f->stride;
+
+        add_candidate(f, id, &n_cand);
+        if (w > 0) add_candidate(f, id - 1, &n_cand);
+        if (w + 1 < f->stride) add_candidate(f, id + 1, &n_cand);
+        if (id >= f->stride) add_candidate(f, id - f->stride, &n_cand);
+        if (id + f->stride < f->words) add_candidate(f, id + f->stride, &n_cand);
+    }
+
+    size_t n_next = 0;
+    for (size_t i = 0; i < n_cand; i++) {
+        size_t t = f->cand[i];
+        size_t w = t % f->stride;
+        f->queued[t] = 0;
+
+        uint64_t cur = f->front[t];
+        uint64_t reach = cur | cur << 1 | cur >> 1;
+        if (w > 0) reach |= f->front[t - 1] >> (WORD_BITS - 1);
+        if (w + 1 < f->stride) reach |= f->front[t + 1] << (WORD_BITS - 1);
+        if (t >= f->stride) reach |= f->front[t - f->stride];
+        if (t + f->stride < f->words) reach |= f->front[t + f->stride];
+
+        uint64_t fresh = reach & f->open[t] & ~f->seen[t];
+        if (fresh) {
+            f->next[t] = fresh;
+            f->seen[t] |= fresh;
+            if (level % 3 == 1) {
+                f->lvl_lo[t] |= fresh;
+            } else if (level % 3 == 2) {
+                f->lvl_hi[t] |= fresh;
+            }
+            f->new_active[n_next++] = t;
+        }
+    }
+
+    /* The old frontier becomes the (cleared) buffer for the next level. */
+    for (size_t i = 0; i < n_active; i++) {
+        f->front[f->active[i]] = 0;
+    }
+
+    uint64_t *tmp = f->front;
+    f->front = f->next;
+    f->next = tmp;
+
+    size_t *tmp_list = f->active;
+    f->active = f->new_active;
+    f->new_active = tmp_list;
+
+    return n_next;
+}
+
+/**
+ * Counts the cells of the current frontier.
+ *
+ * f: flood fill state.
+ * n_active: number of words in 'active' that hold frontier cells.
+ *
+ * Returns:
+ * the number of frontier cells.
+*/
+static size_t frontier_cells(const struct flood *f, size_t n_active) {
+    size_t count = 0;
+    for (size_t i = 0; i < n_active; i++) {
+        count += (size_t) __builtin_popcountll(f->front[f->active[i]]);
+    }
+    return count;
+}
+
+/**
+ * Marks every explored cell in the maze as VISITED.
+ *
+ * f: flood fill state.
+ * m: maze.
+*/
+static void mark_explored(const struct flood *f, struct maze *m) {
+    for (size_t t = 0; t < f->words; t++) {
+        uint64_t bits = f->seen[t];
+        while (bits) {
+            int c = (int) (t % f->stride) * WORD_BITS + __builtin_ctzll(bits);
+            maze_set(m, (int) (t / f->stride), c, VISITED);
+            bits &= bits - 1;
+        }
+    }
+}
+
+/**
+ * Walks back from the destination to the start by stepping to a neighbor that is one level
+ * closer to the start every time, while drawing the path.
+ *
+ * f: flood fill state.
+ * m: maze.
+ * r: row of the destination.
+ * c: column of the destination.
+ * level: level of the destination.
+ *
+ * Returns:
+ * Total length of the shortest path.
+*/
+static int trace_path(const struct flood *f, struct maze *m, int r, int c, int level) {
+    for (int l = level; l > 0; l--) {
+        maze_set(m, r, c, PATH);
+
+        for (int i = 0; i < N_MOVES; i++) {
+            int r_new = r + m_offsets[i][0];
+            int c_new = c + m_offsets[i][1];
+
+            if (r_new < 0 || r_new >= f->n || c_new < 0 || c_new >= f->n) continue;
+
+            if (test_bit(f, f->seen, r_new, c_new) && level_mod3(f, r_new, c_new) == (l - 1) % 3) {
+                r = r_new;
+                c = c_new;
+                break;
+            }
+        }
+    }
+
+    return level;
+}
+
+int bfs_bitparallel_solve(struct maze *m, struct metrics *mt) {
+    struct flood f;
+    int r = 0, c = 0, dest_r = 0, dest_c = 0;
+
+    if (flood_init(&f, m)) {
+        return ERROR;
+    }
+
+    maze_start(m, &r, &c);
+    maze_destination(m, &dest_r, &dest_c);
+
+    size_t start = word_id(&f, r, c);
+    uint64_t bit = (uint64_t) 1 << (c % WORD_BITS);
+    f.seen[start] |= bit;
+    f.front[start] |= bit;
+    f.active[0] = start;
+
+    size_t n_active = 1;
+    int level = 0;
+    while (n_active > 0 && !test_bit(&f, f.seen, dest_r, dest_c)) {
+        /* The whole frontier is expanded at once, so it is counted as one level. */
+        if (mt) {
+            size_t cells = frontier_cells(&f, n_active);
+            if (metrics_expand_level(mt, level, cells, cells)) {
+                flood_cleanup(&f);
+                return ERROR;
+            }
+        }
+        level++;
+        n_active = expand_level(&f, n_active, level);
+    }
+
+    int len = NOT_FOUND;
+    mark_explored(&f, m);
+    if (test_bit(&f, f.seen, dest_r, dest_c)) {
+        double t0 = metrics_now_ms();
+        len = trace_path(&f, m, dest_r, dest_c, level);
+        if (mt) {
+            mt->path_ms = metrics_now_ms() - t0;
+        }
+    }
+
+    if (mt) {
+        mt->bytes = (N_PLANES * sizeof(uint64_t) + 3 * sizeof(size_t) + sizeof(unsigned char)) * f.words;
+    }
+    flood_cleanup(&f);
+    return len;
+}
@@ -0,0 +1,17 @@
+#ifndef _BFS_BITPARALLEL_H_
+#define _BFS_BITPARALLEL_H_
+
+#include "maze.h"
+#include "metrics.h"
+#include "solver.h"
+
+/* Solves the maze 'm' with a breadth-first flood fill that expands the
+ * frontier 64 cells at a time using the row-aligned wall words of the maze.
+ * The shortest path is marked with PATH and the explored cells with VISITED.
+ * If 'mt' is not NULL the search is measured into it, every frontier as one
+ * level.
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occured. */
+int bfs_bitparallel_solve(struct maze *m, struct metrics *mt);
+
+#endif
@@ -0,0 +1,400 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program provides an external-memory Breadth-First Search (BFS) for mazes that do not fit
+ * in memory. Only a band of rows of the walls and a few file buffers are kept in memory, the
+ * levels of the search live in run files on disk: sorted lists of the row-major indices of the
+ * cells at one distance from the start.
+ *
+ * Level t + 1 is built from level t in one pass. Moving every cell of a sorted level up, down,
+ * left or right keeps it sorted, so the four neighbor lists are four sorted streams of the same
+ * file, and merging them gives all candidates in order. A candidate that is a wall is dropped
+ * while the rows are streamed past in the same order. In an undirected graph every neighbor of
+ * level t lies in level t - 1, t or t + 1, so a candidate that is not in the run of level t - 1
+ * or level t is new, which replaces the visited set of an in-memory search. Only the last three
+ * levels are kept, and all files are read and written sequentially through large buffers.
+ *
+ * Every level reads the bands of rows its cells lie in again. A text maze is therefore first
+ * copied to a binary maze next to the run files, which is read instead: one bit per cell instead
+ * of one character, and no parsing.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bfs_external.h"
+
+#define WORD_BITS 64
+#define N_LEVELS 3
+#define BAND_BYTES (1 << 20)
+#define IO_BUFFER (1 << 16)
+#define NAME_LEN 4096
+#define LEVEL_NAME "/level%d"
+#define WALLS_NAME "/walls.mazb"
+
+/* Buffered sequential reader of a run file. */
+struct run {
+    FILE *fp;
+    uint64_t cur;
+    bool valid;
+};
+
+/* Reader of a level that yields the neighbors of its cells in direction 'dir'. */
+struct shifted {
+    struct run run;
+    int dir;
+};
+
+struct external {
+    struct maze_stream *s;
+    int n;
+    int stride;
+    uint64_t dest;
+    char dir[NAME_LEN];
+    char level[N_LEVELS][NAME_LEN + sizeof(LEVEL_NAME)];
+    char walls[NAME_LEN + sizeof(WALLS_NAME)];
+    uint64_t *band;
+    int band_rows;
+    int band_first;
+    int band_count;
+    struct metrics *mt;
+};
+
+/* Reads the next value of run 'rd'. */
+static void run_next(struct run *rd) {
+    rd->valid = fread(&rd->cur, sizeof(uint64_t), 1, rd->fp) == 1;
+}
+
+/**
+ * Opens the run file 'path' and reads its first value.
+ *
+ * rd: run.
+ * path: name of the run file.
+ *
+ * Returns:
+ * 0 if successful, 1 if the file could not be opened.
+*/
+static int run_open(struct run *rd, const char *path) {
+    rd->fp = fopen(path, "rb");
+    if (!rd->fp) {
+        rd->valid = false;
+        return 1;
+    }
+    setvbuf(rd->fp, NULL, _IOFBF, IO_BUFFER);
+    run_next(rd);
+    return 0;
+}
+
+/* Closes run 'rd'. Returns 1 if a read error occured, 0 otherwise. */
+static int run_close(struct run *rd) {
+    int err = 0;
+    if (rd->fp) {
+        err = ferror(rd->fp) != 0;
+        fclose(rd->fp);
+        rd->fp = NULL;
+    }
+    return err;
+}
+
+/* Advances run 'rd' past all values below 'x'. Returns true if 'x' is in the run. */
+static bool run_contains(struct run *rd, uint64_t x) {
+    while (rd->valid && rd->cur < x) {
+        run_next(rd);
+    }
+    return rd->valid && rd->cur == x;
+}
+
+/**
+ * Gives the next neighbor in direction 'sh->dir' of the cells of a level. Neighbors on the
+ * border of the maze are skipped, as the border is never a valid move.
+ *
+ * e: search state.
+ * sh: shifted reader.
+ * out: receives the neighbor.
+ *
+ * Returns:
+ * true if a neighbor was found, false at the end of the level.
+*/
+static bool shifted_next(const struct external *e, struct shifted *sh, uint64_t *out) {
+    uint64_t n = (uint64_t) e->n;
+
+    while (sh->run.valid) {
+        uint64_t cell = sh->run.cur;
+        int r = (int) (cell / n) + m_offsets[sh->dir][0];
+        int c = (int) (cell % n) + m_offsets[sh->dir][1];
+        run_next(&sh->run);
+
+        if (r > 0 && r < e->n - 1 && c > 0 && c < e->n - 1) {
+            *out = (uint64_t) r * n + (uint64_t) c;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Tells whether a cell is a wall. Cells are asked for in increasing order within a level, so the
+ * band of rows in memory only moves forward, and a new band is read when the row of the cell is
+ * past it.
+ *
+ * e: search state.
+ * cell: row-major index of the cell.
+ * wall: receives true if the cell is a wall.
+ *
+ * Returns:
+ * 0 if successful, 1 if the band could not be read.
+*/
+static int is_wall(struct external *e, uint64_t cell, bool *wall) {
+    int r = (int) (cell / (uint64_t) e->n);
+    int c = (int) (cell % (uint64_t) e->n);
+
+    if (r < e->band_first || r >= e->band_first + e->band_count) {
+        int count = e->n - r < e->band_rows ? e->n - r : e->band_rows;
+        if (maze_stream_rows(e->s, r, count, e->band)) {
+            e->band_count = 0;
+            return 1;
+        }
+        e->band_first = r;
+        e->band_count = count;
+    }
+
+    const uint64_t *row = e->band + (size_t) (r - e->band_first) * (size_t) e->stride;
+    *wall = (row[c / WORD_BITS] >> (c % WORD_BITS)) & 1;
+    return 0;
+}
+
+/**
+ * Builds the next level by merging the four neighbor streams of the current level, dropping
+ * duplicates, cells of the previous and current level, and walls.
+ *
+ * e: search state.
+ * prev: run file of level t - 1.
+ * cur: run file of level t.
+ * next: receives the run file of level t + 1.
+ * found: set to true if the destination is in the next level.
+ *
+ * Returns:
+ * the number of cells in the next level, or ERROR if an error occured.
+*/
+static long expand_level(struct external *e, const char *prev, const char *cur, const char *next,
+                         bool *found) {
+    struct shifted sh[N_MOVES];
+    struct run seen_prev, seen_cur;
+    uint64_t head[N_MOVES];
+    bool has[N_MOVES];
+    bool err = false;
+    long count = 0;
+
+    FILE *out = fopen(next, "wb");
+    int opened = out != NULL;
+    for (int i = 0; i < N_MOVES; i++) {
+        sh[i].dir = i;
+        opened &= run_open(&sh[i].run, cur) == 0;
+    }
+    opened &= run_open(&seen_prev, prev) == 0;
+    opened &= run_open(&seen_cur, cur) == 0;
+
+    if (opened) {
+        setvbuf(out, NULL, _IOFBF, IO_BUFFER);
+        for (int i = 0; i < N_MOVES; i++) {
+            has[i] = shifted_next(e, &sh[i], &head[i]);
+        }
+
+        uint64_t last = UINT64_MAX;
+        while (!err && !*found) {
+            int min = -1;
+            for (int i = 0; i < N_MOVES; i++) {
+                if (has[i] && (min < 0 || head[i] < head[min])) min = i;
+            }
+            if (min < 0) break;
+
+            uint64_t cell = head[min];
+            has[min] = shifted_next(e, &sh[min], &head[min]);
+            if (cell == last) continue;
+            last = cell;
+
+            bool wall = false;
+            if (run_contains(&seen_prev, cell) || run_contains(&seen_cur, cell)) continue;
+            if (is_wall(e, cell, &wall)) {
+                err = true;
+            } else if (!wall) {
+                err = fwrite(&cell, sizeof(uint64_t), 1, out) != 1;
+                count++;
+                *found = cell == e->dest;
+            }
+        }
+    }
+
+    for (int i = 0; i < N_MOVES; i++) {
+        err |= run_close(&sh[i].run);
+    }
+    err |= run_close(&seen_prev);
+    err |= run_close(&seen_cur);
+    if (out) {
+        err |= fclose(out) != 0;
+    }
+    return opened && !err ? count : ERROR;
+}
+
+/**
+ * Writes a run file with the given cells, or an empty one.
+ *
+ * path: name of the run file.
+ * cells: cells in increasing order.
+ * n: number of cells.
+ *
+ * Returns:
+ * 0 if successful, 1 if the file could not be written.
+*/
+static int write_run(const char *path, const uint64_t *cells, size_t n) {
+    FILE *fp = fopen(path, "wb");
+    if (!fp) {
+        return 1;
+    }
+    bool ok = n == 0 || fwrite(cells, sizeof(uint64_t), n, fp) == n;
+    return fclose(fp) != 0 || !ok;
+}
+
+/**
+ * Creates the directory for the run files and the file names of the levels.
+ *
+ * e: search state.
+ *
+ * Returns:
+ * 0 if successful, 1 if the directory could not be created.
+*/
+static int make_run_dir(struct external *e) {
+    const char *tmp = getenv("TMPDIR");
+    if (!tmp || !*tmp) {
+        tmp = "/tmp";
+    }
+    int len = snprintf(e->dir, sizeof(e->dir), "%s/maze_bfs_XXXXXX", tmp);
+    if (len < 0 || len >= NAME_LEN || !mkdtemp(e->dir)) {
+        e->dir[0] = '\0';
+        return 1;
+    }
+    for (int i = 0; i < N_LEVELS; i++) {
+        snprintf(e->level[i], sizeof(e->level[i]), "%s" LEVEL_NAME, e->dir, i);
+    }
+    snprintf(e->walls, sizeof(e->walls), "%s" WALLS_NAME, e->dir);
+    return 0;
+}
+
+/* Removes the run files and their directory. */
+static void remove_run_dir(const struct external *e) {
+    if (!e->dir[0]) {
+        return;
+    }
+    for (int i = 0; i < N_LEVELS; i++) {
+        unlink(e->level[i]);
+    }
+    unlink(e->walls);
+    rmdir(e->dir);
+}
+
+/**
+ * Searches level by level until the destination is found or a level is empty.
+ *
+ * e: search state.
+ * start: row-major index of the start.
+ *
+ * Returns:
+ * the length of the path if a path is found, NOT_FOUND or ERROR otherwise.
+*/
+static int search(struct external *e, uint64_t start) {
+    if (start == e->dest) {
+        return 0;
+    }
+    /* Level 0 holds the start; the level before it is empty. */
+    if (write_run(e->level[0], &start, 1) || write_run(e->level[N_LEVELS - 1], NULL, 0)) {
+        return ERROR;
+    }
+
+    long count = 1;
+    for (int t = 0;; t++) {
+        bool found = false;
+        if (e->mt && metrics_expand_level(e->mt, t, (size_t) count, (size_t) count)) return ERROR;
+        count = expand_level(e, e->level[(t + N_LEVELS - 1) % N_LEVELS], e->level[t % N_LEVELS],
+                             e->level[(t + 1) % N_LEVELS], &found);
+        if (count == ERROR) return ERROR;
+        if (found) return t + 1;
+        if (count == 0) return NOT_FOUND;
+    }
+}
+
+/**
+ * Replaces a text maze stream by a stream of its binary copy in the run directory.
+ *
+ * e: search state with an open stream.
+ *
+ * Returns:
+ * 0 if successful, 1 if the copy could not be made.
+*/
+static int use_binary_copy(struct external *e) {
+    if (maze_stream_is_binary(e->s)) {
+        return 0;
+    }
+    if (maze_stream_write_binary(e->s, e->walls)) {
+        return 1;
+    }
+    maze_stream_close(e->s);
+    e->s = maze_stream_open(e->walls);
+    return e->s == NULL;
+}
+
+int bfs_external_solve(const char *filename, struct metrics *mt) {
+    struct external e;
+    int r = 0, c = 0, len = ERROR;
+    double t0 = metrics_now_ms();
+
+    memset(&e, 0, sizeof(e));
+    e.mt = mt;
+    e.s = maze_stream_open(filename);
+    if (!e.s) {
+        return ERROR;
+    }
+    e.n = maze_stream_size(e.s);
+    if (mt) {
+        mt->size = e.n;
+    }
+    e.stride = maze_stream_stride(e.s);
+    e.band_rows = BAND_BYTES / (e.stride * (int) sizeof(uint64_t));
+    if (e.band_rows < 1) {
+        e.band_rows = 1;
+    }
+    e.band = malloc((size_t) e.band_rows * (size_t) e.stride * sizeof(uint64_t));
+
+    /* The endpoints are taken from the stream of the maze itself, not from its binary copy. */
+    maze_stream_destination(e.s, &r, &c);
+    e.dest = (uint64_t) r * (uint64_t) e.n + (uint64_t) c;
+    maze_stream_start(e.s, &r, &c);
+    uint64_t start = (uint64_t) r * (uint64_t) e.n + (uint64_t) c;
+
+    if (e.band && !make_run_dir(&e) && !use_binary_copy(&e)) {
+        if (mt) {
+            mt->load_ms = metrics_now_ms() - t0;
+        }
+        len = search(&e, start);
+    }
+    if (mt) {
+        /* The band of rows and the buffers of the four neighbor streams, the two runs of seen
+         * cells and the next level. */
+        mt->bytes = (size_t) e.band_rows * (size_t) e.stride * sizeof(uint64_t) + (N_MOVES + 3) * IO_BUFFER;
+    }
+
+    remove_run_dir(&e);
+    free(e.band);
+    if (e.s) {
+        maze_stream_close(e.s);
+    }
+    return len;
+}
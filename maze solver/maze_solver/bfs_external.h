@@ -0,0 +1,20 @@
+#ifndef _BFS_EXTERNAL_H_
+#define _BFS_EXTERNAL_H_
+
+#include "maze.h"
+#include "metrics.h"
+#include "solver.h"
+
+/* Finds the length of the shortest path in the maze file 'filename', a text
+ * or binary maze, without loading the maze into memory. The walls are read
+ * in bands of rows and every level of the search is kept in a sorted run
+ * file in a new directory under $TMPDIR, or /tmp, which is removed again.
+ * The path itself is not marked, as there is no maze in memory to mark it.
+ * If 'mt' is not NULL the search is measured into it, every level as a
+ * whole; opening the maze and copying a text maze count as loading it, and
+ * the size of the maze is filled in as well.
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occured. */
+int bfs_external_solve(const char *filename, struct metrics *mt);
+
+#endif
@@ -0,0 +1,367 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program provides a multithreaded, level-synchronous Breadth-First Search (BFS) for the
+ * maze solver. The cells of one level are split evenly over the threads. A thread claims a new
+ * cell by swapping its parent from UNSEEN to the current cell with an atomic compare-and-swap,
+ * so every cell is claimed by exactly one thread, and appends it to its own buffer. Between two
+ * levels the buffers are concatenated into the next frontier, each thread copying its own part
+ * at an offset computed by thread 0. Barriers separate the phases of a level.
+ *
+ * The maze itself is only written after the search, by the calling thread, because cells that
+ * share a word of the bit planes cannot be updated from different threads.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bfs_parallel.h"
+
+#define UNSEEN -1
+
+struct shared {
+    const struct maze *m;
+    int n_threads;
+    atomic_int *parent;
+    int *front;
+    size_t n_front;
+    size_t front_cap;
+    int *next;
+    size_t n_next;
+    size_t next_cap;
+    int dest;
+    struct metrics *mt;
+    int level;
+    bool done;
+    atomic_bool failed;
+    pthread_barrier_t barrier;
+    pthread_mutex_t gate;
+};
+
+struct worker {
+    struct shared *sh;
+    int id;
+    int *buf;
+    size_t n_buf;
+    size_t cap;
+    size_t offset;
+    pthread_t thread;
+};
+
+/**
+ * Appends a claimed cell to the buffer of a worker, growing the buffer if needed.
+ *
+ * w: worker.
+ * idx: index of the cell.
+ *
+ * Returns:
+ * 0 if successful, 1 if the buffer could not grow.
+*/
+static int buf_push(struct worker *w, int idx) {
+    if (w->n_buf == w->cap) {
+        size_t cap = w->cap ? w->cap * 2 : 1024;
+        int *buf = realloc(w->buf, sizeof(int) * cap);
+        if (buf == NULL) return 1;
+        w->buf = buf;
+        w->cap = cap;
+    }
+    w->buf[w->n_buf++] = idx;
+    return 0;
+}
+
+/**
+ * Expands the part of the current frontier that belongs to worker 'w' into its buffer.
+ *
+ * w: worker.
+*/
+static void expand_slice(struct worker *w) {
+    struct shared *sh = w->sh;
+    const struct maze *m = sh->m;
+    size_t from = sh->n_front * (size_t) w->id / (size_t) sh->n_threads;
+    size_t to = sh->n_front * (size_t) (w->id + 1) / (size_t) sh->n_threads;
+
+    w->n_buf = 0;
+    for (size_t i = from; i < to; i++) {
+        int cur = sh->front[i];
+        int r = maze_row(m, cur);
+        int c = maze_col(m, cur);
+        unsigned open = maze_open_neighbors(m, r, c);
+
+        for (int dir = 0; dir < N_MOVES; dir++) {
+            if (!((open >> dir) & 1)) continue;
+
+            int r_new = r + m_offsets[dir][0];
+            int c_new = c + m_offsets[dir][1];
+            if (!maze_valid_move(m, r_new, c_new)) continue;
+
+            int idx = maze_index(m, r_new, c_new);
+            int expected = UNSEEN;
+            if (atomic_load_explicit(&sh->parent[idx], memory_order_relaxed) != UNSEEN) continue;
+            if (!atomic_compare_exchange_strong(&sh->parent[idx], &expected, cur)) continue;
+
+            if (buf_push(w, idx)) {
+                atomic_store(&sh->failed, true);
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * Serial step of thread 0 between two levels: computes where every worker copies its buffer and
+ * decides if the search is done.
+ *
+ * sh: shared state.
+ * workers: all workers.
+*/
+static void plan_next_level(struct shared *sh, struct worker *workers) {
+    size_t total = 0;
+    for (int t = 0; t < sh->n_threads; t++) {
+        workers[t].offset = total;
+        total += workers[t].n_buf;
+    }
+
+    /* The frontier that was just expanded is one level of the measurements. */
+    if (sh->mt && metrics_expand_level(sh->mt, sh->level++, sh->n_front, sh->n_front)) {
+        atomic_store(&sh->failed, true);
+    }
+
+    if (atomic_load(&sh->failed) || total == 0 || atomic_load(&sh->parent[sh->dest]) != UNSEEN) {
+        sh->done = true;
+        return;
+    }
+
+    if (total > sh->next_cap) {
+        int *next = realloc(sh->next, sizeof(int) * total);
+        if (next == NULL) {
+            atomic_store(&sh->failed, true);
+            sh->done = true;
+            return;
+        }
+        sh->next = next;
+        sh->next_cap = total;
+    }
+    sh->n_next = total;
+}
+
+/**
+ * Makes the next frontier the current one. Only called by thread 0.
+ *
+ * sh: shared state.
+*/
+static void swap_frontiers(struct shared *sh) {
+    int *tmp = sh->front;
+    sh->front = sh->next;
+    sh->next = tmp;
+
+    size_t cap = sh->front_cap;
+    sh->front_cap = sh->next_cap;
+    sh->next_cap = cap;
+
+    sh->n_front = sh->n_next;
+}
+
+/**
+ * Main loop of every thread, including the calling thread as worker 0. A level has three
+ * phases: expanding the slices, planning by thread 0, and copying the buffers into the next
+ * frontier.
+ *
+ * arg: the worker.
+ *
+ * Returns:
+ * NULL
+*/
+static void *run(void *arg) {
+    struct worker *w = arg;
+    struct shared *sh = w->sh;
+
+    for (;;) {
+        expand_slice(w);
+        pthread_barrier_wait(&sh->barrier);
+
+        if (w->id == 0) {
+            plan_next_level(sh, w);
+        }
+        pthread_barrier_wait(&sh->barrier);
+        if (sh->done) break;
+
+        memcpy(sh->next + w->offset, w->buf, sizeof(int) * w->n_buf);
+        pthread_barrier_wait(&sh->barrier);
+
+        if (w->id == 0) {
+            swap_frontiers(sh);
+        }
+        pthread_barrier_wait(&sh->barrier);
+    }
+
+    return NULL;
+}
+
+/**
+ * Marks the explored cells with VISITED and draws the path by following the parents from the
+ * destination back to the start.
+ *
+ * m: maze
+ * parent: parent of every explored cell, UNSEEN otherwise.
+ * dest: index of the destination.
+ * mt: measurements that receive the time to draw the path, or NULL.
+ *
+ * Returns:
+ * Total length of the shortest path, or NOT_FOUND if the destination was not reached.
+*/
+static int mark_maze(struct maze *m, atomic_int *parent, int dest, struct metrics *mt) {
+    int n = maze_size(m);
+
+    for (int r = 0; r < n; r++) {
+        for (int c = 0; c < n; c++) {
+            if (atomic_load_explicit(&parent[maze_index(m, r, c)], memory_order_relaxed) != UNSEEN) {
+                maze_set(m, r, c, VISITED);
+            }
+        }
+    }
+
+    if (atomic_load(&parent[dest]) == UNSEEN) return NOT_FOUND;
+
+    double t0 = metrics_now_ms();
+    int len = 0;
+    int idx = dest;
+    while (!maze_at_start(m, maze_row(m, idx), maze_col(m, idx))) {
+        maze_set(m, maze_row(m, idx), maze_col(m, idx), PATH);
+        idx = atomic_load(&parent[idx]);
+        len++;
+    }
+    if (mt) {
+        mt->path_ms = metrics_now_ms() - t0;
+    }
+
+    return len;
+}
+
+/**
+ * Entry point of the started threads. They wait at the gate until all threads are created and
+ * the barrier is set up for the number of threads that could actually be started.
+ *
+ * arg: the worker.
+ *
+ * Returns:
+ * NULL
+*/
+static void *start_worker(void *arg) {
+    struct worker *w = arg;
+
+    pthread_mutex_lock(&w->sh->gate);
+    pthread_mutex_unlock(&w->sh->gate);
+
+    if (w->sh->done) return NULL;
+    return run(w);
+}
+
+/**
+ * Starts the worker threads, runs worker 0 on the calling thread and waits for the others. If
+ * not every thread can be created the search runs on the threads that were.
+ *
+ * sh: shared state with the start cell in the frontier.
+ * workers: array of 'sh->n_threads' workers.
+ *
+ * Returns:
+ * 0 if successful, 1 if an error occured.
+*/
+static int run_workers(struct shared *sh, struct worker *workers) {
+    if (pthread_mutex_init(&sh->gate, NULL)) return 1;
+    pthread_mutex_lock(&sh->gate);
+
+    int started = 1;
+    for (int t = 0; t < sh->n_threads; t++) {
+        workers[t].sh = sh;
+        workers[t].id = t;
+    }
+    for (int t = 1; t < sh->n_threads; t++) {
+        if (pthread_create(&workers[t].thread, NULL, start_worker, &workers[t])) break;
+        started++;
+    }
+    sh->n_threads = started;
+
+    int err = pthread_barrier_init(&sh->barrier, NULL, (unsigned) started) != 0;
+    if (err) {
+        /* Let the started threads leave right away. */
+        sh->done = true;
+        atomic_store(&sh->failed, true);
+    }
+    pthread_mutex_unlock(&sh->gate);
+
+    if (!err) {
+        run(&workers[0]);
+    }
+    for (int t = 1; t < started; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+
+    if (!err) {
+        pthread_barrier_destroy(&sh->barrier);
+    }
+    pthread_mutex_destroy(&sh->gate);
+    return atomic_load(&sh->failed);
+}
+
+int bfs_parallel_solve(struct maze *m, int n_threads, struct metrics *mt) {
+    size_t cells = maze_cells(m);
+    struct shared sh;
+    int r = 0, c = 0;
+
+    if (n_threads < 1) return ERROR;
+
+    memset(&sh, 0, sizeof(sh));
+    sh.m = m;
+    sh.n_threads = n_threads;
+    sh.mt = mt;
+    sh.parent = malloc(sizeof(atomic_int) * cells);
+    sh.front = malloc(sizeof(int));
+    sh.front_cap = 1;
+    struct worker *workers = calloc((size_t) n_threads, sizeof(struct worker));
+    atomic_init(&sh.failed, false);
+
+    int len = ERROR;
+    if (sh.parent && sh.front && workers) {
+        for (size_t i = 0; i < cells; i++) {
+            atomic_init(&sh.parent[i], UNSEEN);
+        }
+
+        maze_destination(m, &r, &c);
+        sh.dest = maze_index(m, r, c);
+        maze_start(m, &r, &c);
+        int start = maze_index(m, r, c);
+        atomic_store(&sh.parent[start], start);
+        sh.front[0] = start;
+        sh.n_front = 1;
+
+        if (!run_workers(&sh, workers)) {
+            len = mark_maze(m, sh.parent, sh.dest, mt);
+        }
+    }
+
+    if (mt) {
+        mt->bytes = sizeof(atomic_int) * cells + sizeof(int) * (sh.front_cap + sh.next_cap)
+                    + sizeof(struct worker) * (size_t) n_threads;
+    }
+    if (workers) {
+        for (int t = 0; t < n_threads; t++) {
+            if (mt) {
+                mt->bytes += sizeof(int) * workers[t].cap;
+            }
+            free(workers[t].buf);
+        }
+    }
+    free(workers);
+    free(sh.parent);
+    free(sh.front);
+    free(sh.next);
+    return len;
+}
@@ -0,0 +1,18 @@
+#ifndef _BFS_PARALLEL_H_
+#define _BFS_PARALLEL_H_
+
+#include "maze.h"
+#include "metrics.h"
+#include "solver.h"
+
+/* Solves the maze 'm' with a level-synchronous breadth-first search on
+ * 'n_threads' threads. Every level of the frontier is split over the threads,
+ * which claim new cells with an atomic compare-and-swap on the parent array.
+ * The shortest path is marked with PATH and the explored cells with VISITED.
+ * If 'mt' is not NULL the search is measured into it, every frontier as one
+ * level.
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occured. */
+int bfs_parallel_solve(struct maze *m, int n_threads, struct metrics *mt);
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program is a small model of a two-level data cache, for measuring cache misses where
+ * neither perf nor valgrind is available. Code compiled with -fsanitize=kernel-address and
+ * --param asan-instrumentation-with-call-threshold=0 calls a check function before every load
+ * and store; this file defines those functions and runs each access through the model instead.
+ * It is linked into the solvers by make cachesim and must itself be compiled without the
+ * instrumentation. The first level (D1) is 32 KiB and 8-way, the last level (LL) 8 MiB and
+ * 16-way, both with 64-byte lines and least recently used replacement, and every access goes
+ * to LL when it misses D1. When the program exits one line with the counts is written to stderr.
+ * Only instrumented code is counted, so the work done inside the C library, like the zeroing
+ * by calloc(), is left out.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LINE_BITS 6
+
+#define D1_SETS 64
+#define D1_WAYS 8
+#define LL_SETS 8192
+#define LL_WAYS 16
+
+/* One cache level: the tags of the lines in every set, most recently used first. Tag 0 is never
+ * a real line, since the first page of memory is not mapped. */
+struct level {
+    size_t n_sets;
+    size_t n_ways;
+    uintptr_t *tags;
+    long misses;
+};
+
+static uintptr_t d1_tags[D1_SETS * D1_WAYS];
+static uintptr_t ll_tags[LL_SETS * LL_WAYS];
+static struct level d1 = { D1_SETS, D1_WAYS, d1_tags, 0 };
+static struct level ll = { LL_SETS, LL_WAYS, ll_tags, 0 };
+static long accesses = 0;
+
+/**
+ * Looks up a line in a cache level and makes it the most recently used line of its set. On a
+ * miss the least recently used line of the set is dropped.
+ *
+ * lv: cache level.
+ * line: address of the line, the byte address shifted right by LINE_BITS.
+ *
+ * Returns:
+ * 1 if the line was in the level, 0 if it was a miss.
+*/
+static int touch(struct level *lv, uintptr_t line) {
+    uintptr_t *set = lv->tags + (line % lv->n_sets) * lv->n_ways;
+    size_t way = 0;
+
+    while (way < lv->n_ways && set[way] != line) {
+        way++;
+    }
+    int hit = way < lv->n_ways;
+    if (!hit) {
+        lv->misses++;
+        way = lv->n_ways - 1;
+    }
+    memmove(set + 1, set, way * sizeof(uintptr_t));
+    set[0] = line;
+    return hit;
+}
+
+/* Runs an access of 'size' bytes at 'addr' through the model, one lookup for every line it
+ * touches. */
+static void access_range(uintptr_t addr, size_t size) {
+    uintptr_t last = (addr + (size ? size - 1 : 0)) >> LINE_BITS;
+
+    for (uintptr_t line = addr >> LINE_BITS; line <= last; line++) {
+        accesses++;
+        if (!touch(&d1, line)) {
+            touch(&ll, line);
+        }
+    }
+}
+
+#define CHECK(size) \
+    void __asan_load##size##_noabort(uintptr_t addr); \
+    void __asan_store##size##_noabort(uintptr_t addr); \
+    void __asan_load##size##_noabort(uintptr_t addr) { access_range(addr, size); } \
+    void __asan_store##size##_noabort(uintptr_t addr) { access_range(addr, size); }
+
+CHECK(1)
+CHECK(2)
+CHECK(4)
+CHECK(8)
+CHECK(16)
+
+void __asan_loadN_noabort(uintptr_t addr, size_t size);
+void __asan_storeN_noabort(uintptr_t addr, size_t size);
+void __asan_handle_no_return(void);
+
+void __asan_loadN_noabort(uintptr_t addr, size_t size) {
+    access_range(addr, size);
+}
+
+void __asan_storeN_noabort(uintptr_t addr, size_t size) {
+    access_range(addr, size);
+}
+
+/* Called before a function that does not return, like longjmp(); there is nothing to do. */
+void __asan_handle_no_return(void) {
+}
+
+/* Writes the counts of the run to stderr when the program exits. */
+__attribute__((destructor)) static void report(void) {
+    fprintf(stderr, "cachesim: %ld accesses, %ld D1 misses, %ld LL misses\n", accesses, d1.misses,
+            ll.misses);
+}
@@ -0,0 +1,168 @@
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "iheap.h"
+
+/* For older versions of the check library */
+#ifndef ck_assert_ptr_nonnull
+#define ck_assert_ptr_nonnull(X) _ck_assert_ptr(X, !=, NULL)
+#endif
+#ifndef ck_assert_ptr_null
+#define ck_assert_ptr_null(X) _ck_assert_ptr(X, ==, NULL)
+#endif
+
+
+START_TEST(test_iheap_init_cleanup) {
+    struct iheap *h = iheap_init(10);
+    ck_assert_ptr_nonnull(h);
+    ck_assert_int_eq(iheap_empty(h), 1);
+    iheap_cleanup(h);
+}
+END_TEST
+
+START_TEST(test_iheap_order) {
+    struct iheap *h = iheap_init(10);
+    ck_assert_int_eq(iheap_push(h, 3, 30), 0);
+    ck_assert_int_eq(iheap_push(h, 1, 10), 0);
+    ck_assert_int_eq(iheap_push(h, 7, 70), 0);
+    ck_assert_int_eq(iheap_push(h, 5, 20), 0);
+
+    ck_assert_int_eq(iheap_pop(h), 1);
+    ck_assert_int_eq(iheap_pop(h), 5);
+    ck_assert_int_eq(iheap_pop(h), 3);
+    ck_assert_int_eq(iheap_pop(h), 7);
+    ck_assert_int_eq(iheap_empty(h), 1);
+    iheap_cleanup(h);
+}
+END_TEST
+
+START_TEST(test_iheap_decrease_key) {
+    struct iheap *h = iheap_init(10);
+    ck_assert_int_eq(iheap_push(h, 1, 10), 0);
+    ck_assert_int_eq(iheap_push(h, 2, 20), 0);
+    ck_assert_int_eq(iheap_push(h, 3, 30), 0);
+
+    /* Lower key moves the item forward, a higher key is ignored. */
+    ck_assert_int_eq(iheap_push(h, 3, 5), 0);
+    ck_assert_int_eq(iheap_push(h, 1, 50), 0);
+    ck_assert_int_eq(iheap_size(h), 3);
+
+    ck_assert_int_eq(iheap_pop(h), 3);
+    ck_assert_int_eq(iheap_pop(h), 1);
+    ck_assert_int_eq(iheap_pop(h), 2);
+    iheap_cleanup(h);
+}
+END_TEST
+
+START_TEST(test_iheap_contains) {
+    struct iheap *h = iheap_init(10);
+    ck_assert(!iheap_contains(h, 4));
+    ck_assert_int_eq(iheap_push(h, 4, 1), 0);
+    ck_assert(iheap_contains(h, 4));
+    ck_assert_int_eq(iheap_pop(h), 4);
+    ck_assert(!iheap_contains(h, 4));
+    iheap_cleanup(h);
+}
+END_TEST
+
+START_TEST(test_iheap_remove) {
+    struct iheap *h = iheap_init(10);
+    ck_assert(iheap_top_key(h) == UINT64_MAX);
+    for (int i = 0; i < 8; i++) {
+        ck_assert_int_eq(iheap_push(h, i, (uint64_t) (10 * i)), 0);
+    }
+
+    /* Removing the top, a middle item and the last entry keeps the order. */
+    ck_assert_int_eq(iheap_remove(h, 0), 0);
+    ck_assert_int_eq(iheap_remove(h, 3), 0);
+    ck_assert_int_eq(iheap_remove(h, 7), 0);
+    ck_assert_int_eq(iheap_remove(h, 3), 0);
+    ck_assert(!iheap_contains(h, 3));
+    ck_assert_int_eq(iheap_size(h), 5);
+    ck_assert(iheap_top_key(h) == 10);
+
+    ck_assert_int_eq(iheap_pop(h), 1);
+    ck_assert_int_eq(iheap_pop(h), 2);
+    ck_assert_int_eq(iheap_pop(h), 4);
+    ck_assert_int_eq(iheap_pop(h), 5);
+    ck_assert_int_eq(iheap_pop(h), 6);
+    ck_assert_int_eq(iheap_empty(h), 1);
+    iheap_cleanup(h);
+}
+END_TEST
+
+START_TEST(test_iheap_grow) {
+    struct iheap *h = iheap_init(1000);
+    for (int i = 0; i < 1000; i++) {
+        ck_assert_int_eq(iheap_push(h, i, (uint64_t) (999 - i)), 0);
+    }
+    ck_assert_int_eq(iheap_size(h), 1000);
+
+    for (int i = 999; i >= 0; i--) {
+        ck_assert_int_eq(iheap_pop(h), i);
+    }
+    ck_assert_int_eq(iheap_pop(h), -1);
+    iheap_cleanup(h);
+}
+END_TEST
+
+START_TEST(test_iheap_out_of_range) {
+    struct iheap *h = iheap_init(5);
+    ck_assert_int_eq(iheap_push(h, 5, 1), 1);
+    ck_assert_int_eq(iheap_push(h, -1, 1), 1);
+    ck_assert_int_eq(iheap_empty(h), 1);
+    iheap_cleanup(h);
+}
+END_TEST
+
+START_TEST(test_iheap_null_ptr) {
+    iheap_cleanup(NULL);
+    iheap_stats(NULL);
+    ck_assert(iheap_bytes(NULL) == 0);
+    ck_assert_int_eq(iheap_push(NULL, 0, 1), 1);
+    ck_assert_int_eq(iheap_pop(NULL), -1);
+    ck_assert_int_eq(iheap_empty(NULL), -1);
+    ck_assert(!iheap_contains(NULL, 0));
+    ck_assert_int_eq(iheap_remove(NULL, 0), 1);
+    ck_assert(iheap_top_key(NULL) == UINT64_MAX);
+}
+END_TEST
+
+Suite *iheap_suite(void) {
+    Suite *s;
+    TCase *tc_core;
+    TCase *tc_limits;
+    s = suite_create("iheap");
+
+    tc_core = tcase_create("Core");
+    tcase_add_test(tc_core, test_iheap_init_cleanup);
+    tcase_add_test(tc_core, test_iheap_order);
+    tcase_add_test(tc_core, test_iheap_decrease_key);
+    tcase_add_test(tc_core, test_iheap_contains);
+    tcase_add_test(tc_core, test_iheap_remove);
+
+    tc_limits = tcase_create("Limits");
+    tcase_add_test(tc_limits, test_iheap_grow);
+    tcase_add_test(tc_limits, test_iheap_out_of_range);
+    tcase_add_test(tc_limits, test_iheap_null_ptr);
+
+    suite_add_tcase(s, tc_core);
+    suite_add_tcase(s, tc_limits);
+
+    return s;
+}
+
+int main(void) {
+    int number_failed;
+    Suite *s;
+    SRunner *sr;
+
+    s = iheap_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_VERBOSE);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
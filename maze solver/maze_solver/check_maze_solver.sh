@@ -19,15 +19,16 @@ cleanup() {
 }
 
 function run_and_check_length() {
-    PROG="$1"
+    local -a CMD
+    read -r -a CMD <<< "$1"
     input="$2"
     ref_output="$3"
     ret_val=${4:-0}
 
     echo -n "Checking $(basename "$input"): "
 
-    # First check if $PROG returns a 0 error code and bail
-    if ! "$PROG" < "$input" > /dev/null 2>&1;
+    # First check if $CMD returns a 0 error code and bail
+    if ! "${CMD[@]}" < "$input" > /dev/null 2>&1;
     then
         if [ "$ret_val" -eq 0 ]
         then
@@ -48,8 +49,9 @@ function run_and_check_length() {
     fi
 
     # NOTE: error message is not correct when no path is found with ret val 0
-    "$PROG" < "$input" | grep "found a path of length:" > tmp || true
-    if grep "found a path of length:" "$ref_output" | diff - tmp > /dev/null;
+    # Only compare the length, the line starts with the name of the solver.
+    "${CMD[@]}" < "$input" | grep -o "found a path of length:.*" > tmp || true
+    if grep -o "found a path of length:.*" "$ref_output" | diff - tmp > /dev/null;
     then
         echo "correct"
     else
@@ -65,13 +67,14 @@ function run_and_check_length() {
 }
 
 function run_and_check_path() {
-    PROG="$1"
+    local -a CMD
+    read -r -a CMD <<< "$1"
     input="$2"
     ref_output="$3"
     ret_val=${4:-0}
 
-    # First check if $PROG returns a 0 error code and bail
-    if ! "$PROG" < "$input" > /dev/null 2>&1;
+    # First check if $CMD returns a 0 error code and bail
+    if ! "${CMD[@]}" < "$input" > /dev/null 2>&1;
     then
         if [ "$ret_val" -eq 0 ]
         then
@@ -89,7 +92,7 @@ function run_and_check_path() {
     fi
 
     echo -n "Checking $(basename "$input"): "
-    if diff <("$PROG" < "$input"  | grep -v "found a path" | sed 's/[^x]/_/g') \
+    if diff <("${CMD[@]}" < "$input"  | grep -v "found a path" | sed 's/[^x]/_/g') \
         <(grep -v "found a path" "$ref_output" | sed 's/[^x]/_/g');
     then
         echo "correct"
@@ -100,7 +103,8 @@ function run_and_check_path() {
 }
 
 # usage: check_maze_solvers [solver] [method: length/path] [ret_val] [mazes..]
-PROG=$1 
+# The solver may include options, e.g. "./maze_solver_bfs --bitparallel".
+PROG=$1
 METHOD=$2
 RET_VAL=$3
 shift 3
@@ -117,11 +121,15 @@ fi
 for input in "$@"
 do
     #echo $input
-    if [[ $PROG == *maze_solver_bfs ]];
+    if [[ $PROG == *maze_solver_dfs* ]];
     then
-        ref="$input.bfs_ref"
-    else
         ref="$input.dfs_ref"
+    elif [[ $PROG == *maze_solver_dial* && -f "$input.dial_ref" ]];
+    then
+        # Weighted mazes have their own reference, costs count in the length
+        ref="$input.dial_ref"
+    else
+        ref="$input.bfs_ref"
     fi
     if [[ $METHOD == "length" ]];
     then
@@ -32,3 +32,267 @@ echo "Checking the path length for special mazes..."
 # Check if mazes with no path are handled correctly
 ./check_maze_solver.sh ./maze_solver_bfs length 1 mazes/maze_impossible.txt
 
+
+# The other BFS modes may pick a different shortest path on multi path mazes,
+# so only their lengths are checked there.
+echo
+echo "Checking the bit-parallel BFS..."
+./check_maze_solver.sh "./maze_solver_bfs --bitparallel" length 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt \
+    mazes/maze_7x7_multiple_paths.txt mazes/maze_15x15_multiple_paths.txt \
+    mazes/maze_7x7_open.txt
+./check_maze_solver.sh "./maze_solver_bfs --bitparallel" length 1 mazes/maze_impossible.txt
+
+echo
+echo "Checking the bidirectional BFS..."
+./check_maze_solver.sh "./maze_solver_bfs --bidirectional" length 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt \
+    mazes/maze_7x7_multiple_paths.txt mazes/maze_15x15_multiple_paths.txt \
+    mazes/maze_7x7_open.txt
+./check_maze_solver.sh "./maze_solver_bfs --bidirectional" path 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt
+./check_maze_solver.sh "./maze_solver_bfs --bidirectional" length 1 mazes/maze_impossible.txt
+
+echo
+echo "Checking the multithreaded BFS..."
+./check_maze_solver.sh "./maze_solver_bfs --threads 4" length 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt \
+    mazes/maze_7x7_multiple_paths.txt mazes/maze_15x15_multiple_paths.txt \
+    mazes/maze_7x7_open.txt
+./check_maze_solver.sh "./maze_solver_bfs --threads 4" path 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt
+./check_maze_solver.sh "./maze_solver_bfs --threads 4" length 1 mazes/maze_impossible.txt
+
+# A* finds shortest paths as well, so it is compared with the BFS references
+echo
+echo "Checking the A* solver..."
+./check_maze_solver.sh ./maze_solver_astar length 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt \
+    mazes/maze_7x7_multiple_paths.txt mazes/maze_15x15_multiple_paths.txt \
+    mazes/maze_7x7_open.txt
+./check_maze_solver.sh ./maze_solver_astar path 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt
+./check_maze_solver.sh ./maze_solver_astar length 1 mazes/maze_impossible.txt
+
+echo
+echo "Checking Jump Point Search..."
+./check_maze_solver.sh "./maze_solver_astar --jps" length 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt \
+    mazes/maze_7x7_multiple_paths.txt mazes/maze_15x15_multiple_paths.txt \
+    mazes/maze_7x7_open.txt
+./check_maze_solver.sh "./maze_solver_astar --jps" path 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt
+./check_maze_solver.sh "./maze_solver_astar --jps" length 1 mazes/maze_impossible.txt
+
+echo
+echo "Checking the junction graph solver..."
+./check_maze_solver.sh ./maze_solver_graph length 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt \
+    mazes/maze_7x7_multiple_paths.txt mazes/maze_15x15_multiple_paths.txt \
+    mazes/maze_7x7_open.txt
+./check_maze_solver.sh ./maze_solver_graph path 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt
+./check_maze_solver.sh ./maze_solver_graph length 1 mazes/maze_impossible.txt
+
+# HPA* paths may be longer than the shortest path in general, but on these
+# small mazes the paths found with clusters of 4 cells are the shortest ones
+echo
+echo "Checking the cluster abstraction (HPA*)..."
+./check_maze_solver.sh "./maze_solver_graph --hpa 4" length 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt \
+    mazes/maze_7x7_multiple_paths.txt mazes/maze_15x15_multiple_paths.txt \
+    mazes/maze_7x7_open.txt
+./check_maze_solver.sh "./maze_solver_graph --hpa 4" path 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt
+./check_maze_solver.sh "./maze_solver_graph --hpa 4" length 1 mazes/maze_impossible.txt
+
+# Without cell costs Dial's algorithm expands the cells in BFS order, so it
+# finds the same paths as the BFS solver. The cheapest path of the 11x11
+# weighted maze must enter a cost cell: it costs 17 through the 2, while the
+# shortest path costs 18 through the 3 and there is no path around both.
+echo
+echo "Checking Dial's algorithm..."
+./check_maze_solver.sh ./maze_solver_dial length 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt \
+    mazes/maze_7x7_multiple_paths.txt mazes/maze_15x15_multiple_paths.txt \
+    mazes/maze_7x7_open.txt mazes/weighted/maze_15x15_weighted.txt \
+    mazes/weighted/maze_11x11_weighted.txt
+./check_maze_solver.sh ./maze_solver_dial path 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt \
+    mazes/maze_7x7_multiple_paths.txt mazes/maze_15x15_multiple_paths.txt \
+    mazes/weighted/maze_15x15_weighted.txt mazes/weighted/maze_11x11_weighted.txt
+./check_maze_solver.sh ./maze_solver_dial length 1 mazes/maze_impossible.txt
+
+# The incremental solver finds shortest paths, also after edits: maze_replan
+# fails if its length after an edit differs from a fresh breadth-first search
+echo
+echo "Checking the incremental solver (LPA*)..."
+./check_maze_solver.sh ./maze_replan length 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt \
+    mazes/maze_7x7_multiple_paths.txt mazes/maze_15x15_multiple_paths.txt \
+    mazes/maze_7x7_open.txt
+./check_maze_solver.sh ./maze_replan path 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt
+./check_maze_solver.sh ./maze_replan length 1 mazes/maze_impossible.txt
+for maze in mazes/maze_7x7_*.txt mazes/maze_15x15_*.txt; do
+    echo -n "Checking $(basename "$maze") (200 edits): "
+    if ./maze_replan --edits 200 --seed 7 < "$maze" > /dev/null; then
+        echo "correct"
+    else
+        echo "not correct"
+    fi
+done
+
+# Dead-end filling must not change the shortest path
+echo
+echo "Checking the solvers on pruned mazes..."
+./check_maze_solver.sh "./maze_solver_bfs --prune" length 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt \
+    mazes/maze_7x7_multiple_paths.txt mazes/maze_15x15_multiple_paths.txt \
+    mazes/maze_7x7_open.txt
+./check_maze_solver.sh "./maze_solver_bfs --prune" path 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt
+./check_maze_solver.sh "./maze_solver_bfs --prune" length 1 mazes/maze_impossible.txt
+echo
+./check_maze_solver.sh "./maze_solver_dfs --prune" length 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt
+./check_maze_solver.sh "./maze_solver_dfs --prune" path 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt
+./check_maze_solver.sh "./maze_solver_dfs --prune" length 1 mazes/maze_impossible.txt
+
+# A maze converted to the binary format must give exactly the same output
+echo
+echo "Checking binary mazes..."
+for maze in mazes/*.txt; do
+    echo -n "Checking $(basename "$maze"): "
+    ./maze_convert tmp.mazb < "$maze"
+    if cmp -s <(./maze_solver_bfs < "$maze") <(./maze_solver_bfs < tmp.mazb) \
+        && cmp -s <(./maze_solver_bfs < "$maze") <(cat tmp.mazb | ./maze_solver_bfs); then
+        echo "correct"
+    else
+        echo "not correct"
+    fi
+done
+rm -f tmp.mazb
+
+# Query the start and destination of every maze, twice to reuse the buffers
+echo
+echo "Checking the query mode..."
+for maze in mazes/*.txt; do
+    query=$(awk '{ s = index($0, "S"); d = index($0, "D");
+                   if (s) start = (NR - 1) " " (s - 1); if (d) dest = (NR - 1) " " (d - 1) }
+                 END { print start, dest }' "$maze")
+    expected=$(grep -o "found a path of length: .*" "$maze.bfs_ref" | grep -o "[0-9]*$" || echo -1)
+    # The labels are saved in the first "labels" run and loaded in the "saved" run
+    for mode in bfs graph hpa labels saved; do
+        flags=()
+        [ "$mode" == graph ] && flags=(--graph)
+        [ "$mode" == hpa ] && flags=(--hpa 4)
+        [ "$mode" == labels ] || [ "$mode" == saved ] && flags=(--labels tmp.labels)
+        echo -n "Checking $(basename "$maze") ($mode): "
+        if [ "$(printf "%s\n%s\n" "$query" "$query" | ./maze_query "${flags[@]}" "$maze" | uniq)" \
+            == "$expected" ]; then
+            echo "correct"
+        else
+            echo "not correct"
+        fi
+    done
+    rm -f tmp.labels
+done
+
+# The batch solver must report the same lengths as the solver, in input order
+echo
+echo "Checking the batch solver..."
+for threads in 1 4; do
+    echo -n "Checking mazes/ with $threads threads: "
+    expected=$(for maze in mazes/*.txt; do
+                   length=$(./maze_solver_bfs < "$maze" | grep -o "length: [0-9]*" || true)
+                   echo "$maze: ${length:-no path}"
+               done)
+    if [ "$(./maze_batch --threads "$threads" mazes | sed 's/\(\(length [0-9]*\)\|no path found\),.*/\1/' \
+            | sed 's/length /length: /; s/no path found/no path/')" == "$expected" ]; then
+        echo "correct"
+    else
+        echo "not correct"
+    fi
+done
+
+# The distance field holds the length of the path to the destination, and
+# queries from its source are answered from the saved field in both directions
+echo
+echo "Checking the distance field..."
+./check_maze_solver.sh "./maze_solver_bfs --distances tmp.dist --heatmap tmp.ppm" length 0 \
+    mazes/maze_7x7_single_path.txt mazes/maze_15x15_single_path.txt \
+    mazes/maze_7x7_multiple_paths.txt mazes/maze_15x15_multiple_paths.txt \
+    mazes/maze_7x7_open.txt
+./check_maze_solver.sh "./maze_solver_bfs --distances tmp.dist" length 1 mazes/maze_impossible.txt
+for maze in mazes/*.txt; do
+    query=$(awk '{ s = index($0, "S"); d = index($0, "D");
+                   if (s) start = (NR - 1) " " (s - 1); if (d) dest = (NR - 1) " " (d - 1) }
+                 END { print start, dest; print dest, start }' "$maze")
+    expected=$(grep -o "found a path of length: .*" "$maze.bfs_ref" | grep -o "[0-9]*$" || echo -1)
+    echo -n "Checking $(basename "$maze") (distances): "
+    ./maze_solver_bfs --distances tmp.dist < "$maze" > /dev/null || true
+    if [ "$(echo "$query" | ./maze_query --distances tmp.dist "$maze" | uniq)" == "$expected" ]; then
+        echo "correct"
+    else
+        echo "not correct"
+    fi
+done
+rm -f tmp.dist tmp.ppm
+
+# The external-memory BFS reads the maze file itself, text or binary, and
+# only reports the length
+echo
+echo "Checking the external-memory BFS..."
+for maze in mazes/*.txt; do
+    echo -n "Checking $(basename "$maze"): "
+    ./maze_convert tmp.mazb < "$maze"
+    expected=$(grep -o "found a path of length: .*" "$maze.bfs_ref" || echo "no path")
+    if [ "$(./maze_solver_bfs --external "$maze" | grep -o "found a path of length: .*" || echo "no path")" \
+            == "$expected" ] \
+        && [ "$(./maze_solver_bfs --external tmp.mazb | grep -o "found a path of length: .*" || echo "no path")" \
+            == "$expected" ]; then
+        echo "correct"
+    else
+        echo "not correct"
+    fi
+done
+rm -f tmp.mazb
+
+# The statistics must not change the output, and must agree with it: the path
+# length is the one printed and the levels add up to the expanded cells. One
+# thread keeps the path of the multithreaded search the same between runs.
+# usage: check_stats maze command [options]
+check_stats() {
+    local maze=$1
+    shift
+    echo -n "Checking $(basename "$maze") ($*): "
+    json=$("$@" --stats=json < "$maze" 2>&1 >tmp.out | grep "^{")
+    length=$(grep -o "length: [0-9]*" tmp.out | grep -o "[0-9]*$" || echo null)
+    if cmp -s tmp.out <("$@" < "$maze") \
+        && [ "$(echo "$json" | grep -o '"path_length": [0-9a-z]*' | grep -o '[0-9a-z]*$')" == "$length" ] \
+        && [ "$(echo "$json" | sed 's/.*\[\(.*\)\].*/\1/' | awk -F, '{ for (i = 1; i <= NF; i++) n += $i } END { print n + 0 }')" \
+            == "$(echo "$json" | grep -o '"cells_expanded": [0-9]*' | grep -o '[0-9]*$')" ]; then
+        echo "correct"
+    else
+        echo "not correct"
+    fi
+}
+
+echo
+echo "Checking the run statistics..."
+for maze in mazes/*.txt; do
+    for option in "" --prune --bitparallel --bidirectional "--threads 1" "--distances tmp.dist"; do
+        check_stats "$maze" ./maze_solver_bfs $option
+    done
+    check_stats "$maze" ./maze_solver_bfs --external "$maze"
+    check_stats "$maze" ./maze_solver_dfs
+    check_stats "$maze" ./maze_solver_astar
+    check_stats "$maze" ./maze_solver_astar --jps
+    check_stats "$maze" ./maze_solver_graph
+    check_stats "$maze" ./maze_solver_graph --hpa 4
+    check_stats "$maze" ./maze_solver_dial
+    check_stats "$maze" ./maze_replan
+done
+rm -f tmp.out tmp.dist
@@ -23,6 +23,11 @@ START_TEST(test_stack_stats) {
 }
 END_TEST
 
+START_TEST(test_stack_bytes) {
+    ck_assert(stack_bytes(NULL) == 0);
+}
+END_TEST
+
 START_TEST(test_stack_push) {
     ck_assert_int_eq(stack_push(NULL, 0), 1);
 }
@@ -38,6 +43,11 @@ START_TEST(test_stack_peek) {
 }
 END_TEST
 
+START_TEST(test_stack_next_cursor) {
+    ck_assert_int_eq(stack_next_cursor(NULL), -1);
+}
+END_TEST
+
 START_TEST(test_stack_empty) {
     ck_assert_int_eq(stack_empty(NULL), -1);
 }
@@ -58,6 +68,11 @@ START_TEST(test_queue_stats) {
 }
 END_TEST
 
+START_TEST(test_queue_bytes) {
+    ck_assert(queue_bytes(NULL) == 0);
+}
+END_TEST
+
 START_TEST(test_queue_push) {
     ck_assert_int_eq(queue_push(NULL, 2), 1);
 }
@@ -92,15 +107,18 @@ Suite *null_suite(void) {
     tc_stack = tcase_create("Stack");
     tcase_add_test(tc_stack, test_stack_cleanup);
     tcase_add_test(tc_stack, test_stack_stats);
+    tcase_add_test(tc_stack, test_stack_bytes);
     tcase_add_test(tc_stack, test_stack_push);
     tcase_add_test(tc_stack, test_stack_pop);
     tcase_add_test(tc_stack, test_stack_peek);
+    tcase_add_test(tc_stack, test_stack_next_cursor);
     tcase_add_test(tc_stack, test_stack_empty);
     tcase_add_test(tc_stack, test_stack_size);
 
     tc_queue = tcase_create("Queue");
     tcase_add_test(tc_queue, test_queue_cleanup);
     tcase_add_test(tc_queue, test_queue_stats);
+    tcase_add_test(tc_queue, test_queue_bytes);
     tcase_add_test(tc_queue, test_queue_push);
     tcase_add_test(tc_queue, test_queue_pop);
     tcase_add_test(tc_queue, test_queue_peek);
@@ -102,8 +102,6 @@ START_TEST(test_queue_empty) {
 }
 END_TEST
 
-/* If you implement queue resizing (bonus) uncomment this test. */
-/*
 START_TEST(test_queue_realloc) {
     struct queue *q = queue_init(5);
     for (int i = 0; i < 15; i++) {
@@ -163,7 +161,6 @@ START_TEST(test_queue_realloc_zero_size_queue) {
     queue_cleanup(q);
 }
 END_TEST
-*/
 
 START_TEST(test_queue_overflow) {
     struct queue *s = queue_init(5);
@@ -278,14 +275,12 @@ Suite *queue_suite(void) {
     suite_add_tcase(s, tc_core);
     suite_add_tcase(s, tc_limits);
 
-    /* If you implement queue resizing (bonus) uncomment the test
-     * 'test_queue_realloc*' tests above and the lines below. */
-    // TCase *tc_bonus;
-    // tc_bonus = tcase_create("Bonus");
-    // tcase_add_test(tc_bonus, test_queue_realloc);
-    // tcase_add_test(tc_bonus, test_queue_realloc_after_pop);
-    // tcase_add_test(tc_bonus, test_queue_realloc_zero_size_queue);
-    // suite_add_tcase(s, tc_bonus);
+    TCase *tc_bonus;
+    tc_bonus = tcase_create("Bonus");
+    tcase_add_test(tc_bonus, test_queue_realloc);
+    tcase_add_test(tc_bonus, test_queue_realloc_after_pop);
+    tcase_add_test(tc_bonus, test_queue_realloc_zero_size_queue);
+    suite_add_tcase(s, tc_bonus);
 
     return s;
 }
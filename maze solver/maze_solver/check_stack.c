@@ -135,8 +135,6 @@ START_TEST(test_stack_overflow) {
 END_TEST
 
 
-/* If you implement stack resizing (bonus) uncomment this test. */
-/*
 START_TEST(test_stack_realloc) {
     struct stack *s = stack_init(5);
     for (int i = 0; i < 15; i++) {
@@ -157,7 +155,24 @@ START_TEST(test_stack_realloc) {
     stack_cleanup(s);
 }
 END_TEST
-*/
+
+START_TEST(test_stack_cursor) {
+    struct stack *s = stack_init(5);
+    ck_assert_int_eq(stack_next_cursor(s), -1);
+
+    ck_assert_int_eq(stack_push(s, 'x'), 0);
+    ck_assert_int_eq(stack_next_cursor(s), 0);
+    ck_assert_int_eq(stack_next_cursor(s), 1);
+
+    ck_assert_int_eq(stack_push(s, 'y'), 0);
+    ck_assert_int_eq(stack_next_cursor(s), 0);
+
+    ck_assert_int_eq(stack_pop(s), 'y');
+    ck_assert_int_eq(stack_next_cursor(s), 2);
+    ck_assert_int_eq(stack_peek(s), 'x');
+    stack_cleanup(s);
+}
+END_TEST
 
 START_TEST(test_stack_underflow) {
     struct stack *s = stack_init(10);
@@ -230,6 +245,7 @@ Suite *stack_suite(void) {
     tcase_add_test(tc_core, test_stack_push_pop);
     tcase_add_test(tc_core, test_stack_peek);
     tcase_add_test(tc_core, test_stack_empty);
+    tcase_add_test(tc_core, test_stack_cursor);
 
     tc_limits = tcase_create("Limits");
     tcase_add_test(tc_limits, test_stack_overflow);
@@ -240,12 +256,10 @@ Suite *stack_suite(void) {
     suite_add_tcase(s, tc_core);
     suite_add_tcase(s, tc_limits);
 
-    /* If you implement stack resizing (bonus) uncomment the test
-     * 'test_stack_realloc' above and the lines below. */
-    // TCase *tc_bonus;
-    // tc_bonus = tcase_create("Bonus");
-    // tcase_add_test(tc_bonus, test_stack_realloc);
-    // suite_add_tcase(s, tc_bonus);
+    TCase *tc_bonus;
+    tc_bonus = tcase_create("Bonus");
+    tcase_add_test(tc_bonus, test_stack_realloc);
+    suite_add_tcase(s, tc_bonus);
 
     return s;
 }
@@ -0,0 +1,220 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program labels the connected components of the open cells of a maze. Two cells can only
+ * reach each other if they are in the same component, so once the labels are known a query
+ * between unreachable cells is answered with one comparison instead of a search that floods the
+ * whole region around the start.
+ *
+ * The labels are found in a single scan over the grid. Every open cell takes the label of the
+ * open cell left of it, or above it, or gets a new one. When both neighbors are open their labels
+ * are merged in a union-find forest. A second pass replaces every label by the number of its
+ * root, so the components are numbered from 1 up and walls keep label 0.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "components.h"
+
+#define LABELS_MAGIC "MZCC"
+#define LABELS_ORDER 0x01020304u
+
+struct components {
+    int n;
+    size_t cells;
+    int count;
+    uint64_t walls_hash;
+    uint32_t *label;
+};
+
+/* Header of a label file, followed by one 32-bit label per cell. */
+struct labels_header {
+    char magic[4];
+    uint32_t order;
+    uint32_t n;
+    uint32_t count;
+    uint64_t walls_hash;
+};
+
+/* Returns the root of label 'x', while halving the path to it. */
+static uint32_t find(uint32_t *parent, uint32_t x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+/* Merges the trees of labels 'a' and 'b' under the lower root. */
+static void unite(uint32_t *parent, uint32_t a, uint32_t b) {
+    a = find(parent, a);
+    b = find(parent, b);
+    if (a < b) {
+        parent[b] = a;
+    } else if (b < a) {
+        parent[a] = b;
+    }
+}
+
+/* Returns the hash of the walls of maze 'm' that is stored with its labels. */
+static uint64_t walls_hash(const struct maze *m) {
+    /* The labels are stored by maze_index(), so the layout of the indices is part of the hash. */
+    return maze_walls_hash(m) ^ (uint64_t) maze_index(m, 1, 0) << 32;
+}
+
+/* Allocates labels for maze 'm', all 0. Returns NULL if an error occured. */
+static struct components *components_init(const struct maze *m) {
+    int n = maze_size(m);
+    struct components *cc = malloc(sizeof(struct components));
+    if (!cc) {
+        return NULL;
+    }
+    cc->n = n;
+    cc->cells = maze_cells(m);
+    cc->count = 0;
+    cc->walls_hash = walls_hash(m);
+    cc->label = calloc(cc->cells, sizeof(uint32_t));
+    if (!cc->label) {
+        free(cc);
+        return NULL;
+    }
+    return cc;
+}
+
+/**
+ * Gives every open cell a provisional label in one scan, merging labels that meet.
+ *
+ * cc: labels, all 0.
+ * m: maze.
+ * parent: receives the union-find forest of the provisional labels.
+ *
+ * Returns:
+ * the number of provisional labels plus one, or 0 if memory could not be allocated.
+*/
+static uint32_t scan(struct components *cc, const struct maze *m, uint32_t **parent) {
+    size_t cap = 1024;
+    uint32_t next = 1;
+
+    *parent = malloc(cap * sizeof(uint32_t));
+    if (!*parent) return 0;
+    (*parent)[0] = 0;
+
+    for (int r = 1; r < cc->n - 1; r++) {
+        for (int c = 1; c < cc->n - 1; c++) {
+            if (maze_is_wall(m, r, c)) continue;
+
+            uint32_t left = c > 1 ? cc->label[maze_index(m, r, c - 1)] : 0;
+            uint32_t up = r > 1 ? cc->label[maze_index(m, r - 1, c)] : 0;
+            uint32_t l;
+
+            if (left && up) {
+                l = left;
+                if (left != up) unite(*parent, left, up);
+            } else if (left || up) {
+                l = left | up;
+            } else {
+                if (next == cap) {
+                    uint32_t *tmp = realloc(*parent, cap * 2 * sizeof(uint32_t));
+                    if (!tmp) return 0;
+                    *parent = tmp;
+                    cap *= 2;
+                }
+                (*parent)[next] = next;
+                l = next++;
+            }
+            cc->label[maze_index(m, r, c)] = l;
+        }
+    }
+    return next;
+}
+
+struct components *components_label(const struct maze *m) {
+    struct components *cc = components_init(m);
+    if (!cc) {
+        return NULL;
+    }
+
+    uint32_t *parent = NULL;
+    uint32_t n_labels = scan(cc, m, &parent);
+    uint32_t *number = n_labels ? calloc(n_labels, sizeof(uint32_t)) : NULL;
+    if (!number) {
+        free(parent);
+        components_cleanup(cc);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < cc->cells; i++) {
+        if (cc->label[i] == 0) continue;
+
+        uint32_t root = find(parent, cc->label[i]);
+        if (number[root] == 0) {
+            number[root] = (uint32_t) ++cc->count;
+        }
+        cc->label[i] = number[root];
+    }
+
+    free(number);
+    free(parent);
+    return cc;
+}
+
+void components_cleanup(struct components *cc) {
+    if (cc == NULL) return;
+    free(cc->label);
+    free(cc);
+}
+
+int components_count(const struct components *cc) {
+    return cc->count;
+}
+
+bool components_connected(const struct components *cc, int a, int b) {
+    return cc->label[a] != 0 && cc->label[a] == cc->label[b];
+}
+
+int components_save(const struct components *cc, const char *filename) {
+    struct labels_header h = { LABELS_MAGIC, LABELS_ORDER, (uint32_t) cc->n, (uint32_t) cc->count,
+                               cc->walls_hash };
+    size_t cells = cc->cells;
+
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) {
+        fprintf(stderr, "Cannot open file %s\n", filename);
+        return 1;
+    }
+    bool ok = fwrite(&h, sizeof(h), 1, fp) == 1 && fwrite(cc->label, sizeof(uint32_t), cells, fp) == cells;
+    if (fclose(fp) != 0 || !ok) {
+        fprintf(stderr, "Cannot write file %s\n", filename);
+        return 1;
+    }
+    return 0;
+}
+
+struct components *components_load(const struct maze *m, const char *filename) {
+    struct labels_header h;
+
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        return NULL;
+    }
+    struct components *cc = components_init(m);
+    bool ok = cc && fread(&h, sizeof(h), 1, fp) == 1 && memcmp(h.magic, LABELS_MAGIC, 4) == 0
+              && h.order == LABELS_ORDER && h.n == (uint32_t) cc->n && h.walls_hash == cc->walls_hash;
+    if (ok) {
+        ok = fread(cc->label, sizeof(uint32_t), cc->cells, fp) == cc->cells;
+        cc->count = (int) h.count;
+    }
+    fclose(fp);
+
+    if (!ok) {
+        components_cleanup(cc);
+        return NULL;
+    }
+    return cc;
+}
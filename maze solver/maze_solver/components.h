@@ -0,0 +1,35 @@
+#ifndef _COMPONENTS_H_
+#define _COMPONENTS_H_
+
+#include <stdbool.h>
+
+#include "maze.h"
+
+/* Handle to the connected component labels of a maze */
+struct components;
+
+/* Labels the open cells of maze 'm' with the number of the connected
+ * component they belong to, in one scan over the grid with union-find.
+ * Returns a pointer to the labels or NULL if an error occured. */
+struct components *components_label(const struct maze *m);
+
+/* Frees all memory associated with the labels. */
+void components_cleanup(struct components *cc);
+
+/* Returns the number of connected components. */
+int components_count(const struct components *cc);
+
+/* Returns true if a path exists between the cells with maze indices 'a' and
+ * 'b', which is the case if both are open and carry the same label. */
+bool components_connected(const struct components *cc, int a, int b);
+
+/* Writes the labels to 'filename', so they can be loaded with the maze later.
+ * Returns 0 if successful, 1 if an error occured. */
+int components_save(const struct components *cc, const char *filename);
+
+/* Loads the labels of maze 'm' from 'filename'. The file also holds a hash of
+ * the walls it was made for, so labels of another maze are refused.
+ * Returns a pointer to the labels or NULL if an error occured. */
+struct components *components_load(const struct maze *m, const char *filename);
+
+#endif
@@ -0,0 +1,314 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program computes the distance field of a maze: the length of the shortest path from one
+ * source cell to every other cell. A breadth-first search from the source runs until no cell is
+ * left, so after this one search the distance to any destination is a single array read.
+ *
+ * The distances are stored row by row, whatever layout maze_index() uses, so a saved field can be
+ * mapped and read by programs that know nothing about the maze code. A heatmap of the field can
+ * be written as a ppm image.
+*/
+
+// Needed for fileno() and mmap()
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "distance.h"
+
+#define DISTANCE_MAGIC "MAZD"
+#define DISTANCE_ORDER 0x01020304u
+
+/* Number of colors in the heatmap ramp from blue to red. */
+#define RAMP 1020
+
+struct distances {
+    int n;
+    int source;
+    uint32_t max;
+    long reached;
+    uint64_t walls_hash;
+    uint32_t *dist;
+    void *map;
+    size_t map_size;
+};
+
+/* Header of a distance file, followed by one 32-bit distance per cell. The
+ * source is stored as a row-major index. */
+struct distance_header {
+    char magic[4];
+    uint32_t order;
+    uint32_t n;
+    uint32_t source;
+    uint32_t max;
+    uint32_t reached;
+    uint64_t walls_hash;
+};
+
+/* Allocates a handle for the distances of maze 'm' without the distances
+ * themselves. Returns NULL if an error occured. */
+static struct distances *distances_init(const struct maze *m) {
+    struct distances *d = malloc(sizeof(struct distances));
+    if (!d) {
+        return NULL;
+    }
+    d->n = maze_size(m);
+    d->source = 0;
+    d->max = 0;
+    d->reached = 0;
+    d->walls_hash = maze_walls_hash(m);
+    d->dist = NULL;
+    d->map = NULL;
+    d->map_size = 0;
+    return d;
+}
+
+/* Returns the number of cells of the field. */
+static size_t field_cells(const struct distances *d) {
+    return (size_t) d->n * (size_t) d->n;
+}
+
+/**
+ * Floods the maze from the source and stores the distance of every cell it reaches. Every cell
+ * enters the queue once, when its distance is set, so the queue is a plain array with one slot
+ * per cell.
+ *
+ * d: distances, all DISTANCE_UNREACHABLE.
+ * m: maze.
+ * queue: array with room for every cell.
+ * mt: measurements, or NULL.
+ *
+ * Returns:
+ * 0 if successful, 1 if the level histogram could not grow.
+*/
+static int flood(struct distances *d, const struct maze *m, uint32_t *queue, struct metrics *mt) {
+    size_t head = 0, tail = 0;
+
+    d->dist[d->source] = 0;
+    queue[tail++] = (uint32_t) d->source;
+
+    while (head < tail) {
+        if (mt && metrics_expand(mt, (int) d->dist[queue[head]], tail - head)) return 1;
+        uint32_t cur = queue[head++];
+        int r = (int) cur / d->n;
+        int c = (int) cur % d->n;
+        uint32_t next = d->dist[cur] + 1;
+        unsigned open = maze_open_neighbors(m, r, c);
+
+        for (int i = 0; i < N_MOVES; i++) {
+            if (!((open >> i) & 1)) continue;
+
+            int r_new = r + m_offsets[i][0];
+            int c_new = c + m_offsets[i][1];
+            if (!maze_valid_move(m, r_new, c_new)) continue;
+
+            size_t idx = (size_t) r_new * (size_t) d->n + (size_t) c_new;
+            if (d->dist[idx] == DISTANCE_UNREACHABLE) {
+                d->dist[idx] = next;
+                queue[tail++] = (uint32_t) idx;
+            }
+        }
+    }
+
+    d->reached = (long) tail;
+    d->max = d->dist[queue[tail - 1]];
+    return 0;
+}
+
+struct distances *distances_compute(const struct maze *m, struct metrics *mt) {
+    int r = 0, c = 0;
+    struct distances *d = distances_init(m);
+    if (!d) {
+        return NULL;
+    }
+
+    size_t cells = field_cells(d);
+    uint32_t *queue = malloc(cells * sizeof(uint32_t));
+    d->dist = malloc(cells * sizeof(uint32_t));
+    if (!queue || !d->dist) {
+        free(queue);
+        distances_cleanup(d);
+        return NULL;
+    }
+    memset(d->dist, 0xff, cells * sizeof(uint32_t));
+
+    maze_start(m, &r, &c);
+    d->source = r * d->n + c;
+    int err = flood(d, m, queue, mt);
+
+    if (mt) {
+        mt->bytes = 2 * sizeof(uint32_t) * cells;
+    }
+    free(queue);
+    if (err) {
+        distances_cleanup(d);
+        return NULL;
+    }
+    return d;
+}
+
+void distances_cleanup(struct distances *d) {
+    if (!d) {
+        return;
+    }
+    if (d->map) {
+        munmap(d->map, d->map_size);
+    } else {
+        free(d->dist);
+    }
+    free(d);
+}
+
+void distances_source(const struct distances *d, int *r, int *c) {
+    *r = d->source / d->n;
+    *c = d->source % d->n;
+}
+
+long distances_reached(const struct distances *d) {
+    return d->reached;
+}
+
+uint32_t distances_max(const struct distances *d) {
+    return d->max;
+}
+
+int distances_get(const struct distances *d, int r, int c) {
+    if (r < 0 || r >= d->n || c < 0 || c >= d->n) {
+        return NOT_FOUND;
+    }
+    uint32_t dist = d->dist[(size_t) r * (size_t) d->n + (size_t) c];
+    return dist == DISTANCE_UNREACHABLE ? NOT_FOUND : (int) dist;
+}
+
+int distances_save(const struct distances *d, const char *filename) {
+    struct distance_header h = { DISTANCE_MAGIC, DISTANCE_ORDER, (uint32_t) d->n, (uint32_t) d->source,
+                                 d->max, (uint32_t) d->reached, d->walls_hash };
+    size_t cells = field_cells(d);
+
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) {
+        fprintf(stderr, "Cannot open file %s\n", filename);
+        return 1;
+    }
+    bool ok = fwrite(&h, sizeof(h), 1, fp) == 1 && fwrite(d->dist, sizeof(uint32_t), cells, fp) == cells;
+    if (fclose(fp) != 0 || !ok) {
+        fprintf(stderr, "Cannot write file %s\n", filename);
+        return 1;
+    }
+    return 0;
+}
+
+/* Returns true if the 'size' bytes mapped at 'map' hold the distances 'd'
+ * was made for: the right header and exactly one distance per cell. */
+static bool valid_mapping(const struct distances *d, const void *map, size_t size) {
+    const struct distance_header *h = map;
+
+    return size == sizeof(*h) + field_cells(d) * sizeof(uint32_t) && memcmp(h->magic, DISTANCE_MAGIC, 4) == 0
+           && h->order == DISTANCE_ORDER && h->n == (uint32_t) d->n && h->walls_hash == d->walls_hash
+           && h->source < field_cells(d);
+}
+
+struct distances *distances_load(const struct maze *m, const char *filename) {
+    struct stat st;
+
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        return NULL;
+    }
+    struct distances *d = distances_init(m);
+    void *map = MAP_FAILED;
+    if (d && fstat(fileno(fp), &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        map = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fileno(fp), 0);
+    }
+    fclose(fp);
+
+    if (map == MAP_FAILED || !valid_mapping(d, map, (size_t) st.st_size)) {
+        if (map != MAP_FAILED) {
+            munmap(map, (size_t) st.st_size);
+        }
+        distances_cleanup(d);
+        return NULL;
+    }
+
+    const struct distance_header *h = map;
+    d->source = (int) h->source;
+    d->max = h->max;
+    d->reached = (long) h->reached;
+    d->map = map;
+    d->map_size = (size_t) st.st_size;
+    d->dist = (uint32_t *) ((char *) map + sizeof(*h));
+    return d;
+}
+
+/* Set RGB values in color array */
+static void set_rgb(unsigned char color[], unsigned r, unsigned g, unsigned b) {
+    color[0] = (unsigned char) r;
+    color[1] = (unsigned char) g;
+    color[2] = (unsigned char) b;
+}
+
+/* Sets 'color' to the heatmap color of distance 'dist', for fields with largest distance 'max'. */
+static void heat_rgb(unsigned char color[], uint32_t dist, uint32_t max) {
+    unsigned t = max ? (unsigned) ((uint64_t) dist * RAMP / max) : 0;
+    unsigned s = t % 255;
+
+    if (t < 255) {
+        set_rgb(color, 0, s, 255); // blue to cyan
+    } else if (t < 510) {
+        set_rgb(color, 0, 255, 255 - s); // cyan to green
+    } else if (t < 765) {
+        set_rgb(color, s, 255, 0); // green to yellow
+    } else if (t < RAMP) {
+        set_rgb(color, 255, 255 - s, 0); // yellow to red
+    } else {
+        set_rgb(color, 255, 0, 0); // red
+    }
+}
+
+int distances_output_ppm(const struct distances *d, const struct maze *m, const char *filename) {
+    unsigned char *row = malloc((size_t) d->n * 3);
+    if (!row) {
+        return 1;
+    }
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) {
+        fprintf(stderr, "Cannot open file %s\n", filename);
+        free(row);
+        return 1;
+    }
+
+    fprintf(fp, "P6\n%d %d\n255\n", d->n, d->n);
+    bool ok = true;
+    for (int r = 0; r < d->n && ok; r++) {
+        for (int c = 0; c < d->n; c++) {
+            unsigned char *color = row + (size_t) c * 3;
+            uint32_t dist = d->dist[(size_t) r * (size_t) d->n + (size_t) c];
+
+            if (dist != DISTANCE_UNREACHABLE) {
+                heat_rgb(color, dist, d->max);
+            } else if (maze_is_wall(m, r, c)) {
+                set_rgb(color, 255, 255, 255); // white
+            } else {
+                set_rgb(color, 0, 0, 0); // black
+            }
+        }
+        ok = fwrite(row, 3, (size_t) d->n, fp) == (size_t) d->n;
+    }
+
+    free(row);
+    if (fclose(fp) != 0 || !ok) {
+        fprintf(stderr, "Cannot write file %s\n", filename);
+        return 1;
+    }
+    return 0;
+}
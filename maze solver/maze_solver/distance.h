@@ -0,0 +1,60 @@
+#ifndef _DISTANCE_H_
+#define _DISTANCE_H_
+
+#include <stdint.h>
+
+#include "maze.h"
+#include "metrics.h"
+#include "solver.h"
+
+/* Distance stored for cells that cannot be reached from the source. */
+#define DISTANCE_UNREACHABLE UINT32_MAX
+
+/* Handle to the distances from one source cell to every cell of a maze */
+struct distances;
+
+/* Runs a breadth-first search from the start of maze 'm' until every
+ * reachable cell is found and records the distance of each of them. The maze
+ * is only read. If 'mt' is not NULL the search is measured into it.
+ * Returns a pointer to the distances or NULL if an error occured. */
+struct distances *distances_compute(const struct maze *m, struct metrics *mt);
+
+/* Frees all memory associated with the distances. */
+void distances_cleanup(struct distances *d);
+
+/* Sets the integer values pointed to by 'r' and 'c' to the row and column of
+ * the source cell. */
+void distances_source(const struct distances *d, int *r, int *c);
+
+/* Returns the number of cells reachable from the source, the source
+ * included. */
+long distances_reached(const struct distances *d);
+
+/* Returns the largest distance of a reachable cell. */
+uint32_t distances_max(const struct distances *d);
+
+/* Returns the length of the shortest path from the source to (r, c), which
+ * is a single array read, or NOT_FOUND if (r, c) is a wall, unreachable or
+ * outside of the maze. */
+int distances_get(const struct distances *d, int r, int c);
+
+/* Writes the distances to 'filename' as a 32-byte header followed by one
+ * uint32_t per cell, row by row, with DISTANCE_UNREACHABLE for cells that
+ * cannot be reached. The file is meant to be mapped by distances_load() or
+ * any other program.
+ * Returns 0 if successful, 1 if an error occured. */
+int distances_save(const struct distances *d, const char *filename);
+
+/* Maps the distances of maze 'm' from 'filename' and uses them in place. The
+ * file also holds a hash of the walls it was made for, so distances of
+ * another maze are refused.
+ * Returns a pointer to the distances or NULL if an error occured. */
+struct distances *distances_load(const struct maze *m, const char *filename);
+
+/* Writes a heatmap of the distances in Portable Pixmap (ppm) format to
+ * 'filename'. Reachable cells go from blue near the source to red at the
+ * largest distance, walls are white and unreachable cells black.
+ * Returns 0 if successful, 1 if an error occured. */
+int distances_output_ppm(const struct distances *d, const struct maze *m, const char *filename);
+
+#endif
@@ -0,0 +1,541 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program contracts a maze into a junction graph. Most open cells of a generated maze lie in
+ * corridors: they have exactly two open neighbors, so a search can only pass through them. Every
+ * other open cell (a junction or a dead end) becomes a node, and every corridor between two nodes
+ * becomes one edge weighted with the number of moves through it. The graph is stored in
+ * compressed sparse row (CSR) form: the edges of node i are the entries adj_start[i] up to
+ * adj_start[i + 1] of the adjacency arrays. Every edge keeps the list of its corridor cells, so
+ * a path found in the graph can be painted back into the maze.
+ *
+ * A query runs Dijkstra's algorithm on the graph. Start and destination cells that lie inside a
+ * corridor are first walked to the nodes at both ends of their corridor. The scratch buffers of
+ * a search remember which nodes they touched, so the next query only resets those.
+*/
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "adjacency.h"
+#include "graph.h"
+#include "iheap.h"
+
+#define WORD_BITS 64
+#define NO_DIR -1
+#define NO_EDGE -1
+#define MAX_ENDS 2
+
+struct graph {
+    const struct maze *m;
+    int n_nodes;
+    int n_edges;
+    int *node_cell;
+    uint64_t *node_bits;
+    int *adj_start;
+    int *adj_node;
+    int *adj_edge;
+    int *edge_u;
+    int *edge_v;
+    int *cell_start;
+    int *cells;
+};
+
+/* Where the walk from a query cell along its corridor ends up. */
+struct end {
+    int node;
+    int off;
+    int dir;
+};
+
+struct graph_search {
+    const struct graph *g;
+    struct iheap *heap;
+    int *dist;
+    int *prev_edge;
+    int *touched;
+    int n_touched;
+
+    /* Route of the last query. */
+    int start;
+    int dest;
+    int length;
+    int direct_dir;
+    struct end src;
+    struct end dst;
+
+    /* Measurements of the queries, or NULL. */
+    struct metrics *mt;
+};
+
+/* Returns the direction opposite to 'dir' in m_offsets. */
+static int opposite(int dir) {
+    return (dir + 2) % N_MOVES;
+}
+
+/* Returns the index of the cell next to 'idx' in direction 'dir'. */
+static int step(const struct maze *m, int idx, int dir) {
+    return maze_index(m, maze_row(m, idx) + m_offsets[dir][0], maze_col(m, idx) + m_offsets[dir][1]);
+}
+
+/* Returns the mask of directions from cell 'idx' that lead to a cell that may be entered. */
+static unsigned open_moves(const struct maze *m, int idx) {
+    int r = maze_row(m, idx);
+    int c = maze_col(m, idx);
+    unsigned open = maze_open_neighbors(m, r, c);
+
+    for (int dir = 0; dir < N_MOVES; dir++) {
+        if (((open >> dir) & 1) && !maze_valid_move(m, r + m_offsets[dir][0], c + m_offsets[dir][1])) {
+            open &= ~(1u << dir);
+        }
+    }
+    return open;
+}
+
+/* Returns true if cell 'idx' is a node of the graph. */
+static bool is_node(const struct graph *g, int idx) {
+    return (g->node_bits[idx / WORD_BITS] >> (idx % WORD_BITS)) & 1;
+}
+
+/* Returns the node id of the node at cell 'idx' by binary search over the sorted node cells. */
+static int node_id(const struct graph *g, int idx) {
+    int lo = 0, hi = g->n_nodes - 1;
+
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (g->node_cell[mid] < idx) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/* Returns the number of moves through edge 'e'. */
+static int edge_weight(const struct graph *g, int e) {
+    return g->cell_start[e + 1] - g->cell_start[e] + 1;
+}
+
+/**
+ * Marks all nodes in the node bitmap and collects their cells in increasing order.
+ *
+ * g: graph under construction.
+ * nodes: list that receives the node cells.
+ *
+ * Returns:
+ * 0 if successful, 1 if memory could not be allocated.
+*/
+static int find_nodes(struct graph *g, struct int_list *nodes) {
+    const struct maze *m = g->m;
+    int n = maze_size(m);
+    int cells = (int) maze_cells(m);
+
+    /* Walk the indices rather than the rows, so the nodes come out sorted in any layout. */
+    for (int idx = 0; idx < cells; idx++) {
+        int r = maze_row(m, idx);
+        int c = maze_col(m, idx);
+        if (r < 1 || r >= n - 1 || c < 1 || c >= n - 1 || maze_is_wall(m, r, c)) continue;
+
+        if (__builtin_popcount(open_moves(m, idx)) != 2) {
+            g->node_bits[idx / WORD_BITS] |= (uint64_t) 1 << (idx % WORD_BITS);
+            if (list_push(nodes, idx)) return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Follows every corridor that leaves a node. Each corridor is found from both of its ends, so it
+ * is only kept when it is traced from the node with the lower id. Corridors that return to the
+ * node they started from can never be part of a shortest path and are dropped.
+ *
+ * g: graph under construction, with its nodes.
+ * eu, ev: lists that receive the end nodes of the edges.
+ * cstart: list that receives the offset of the first corridor cell of every edge.
+ * cells: list that receives the corridor cells of all edges, from 'eu' to 'ev'.
+ *
+ * Returns:
+ * 0 if successful, 1 if memory could not be allocated.
+*/
+static int trace_edges(struct graph *g, struct int_list *eu, struct int_list *ev,
+                       struct int_list *cstart, struct int_list *cells) {
+    const struct maze *m = g->m;
+
+    for (int u = 0; u < g->n_nodes; u++) {
+        unsigned moves = open_moves(m, g->node_cell[u]);
+
+        for (int dir = 0; dir < N_MOVES; dir++) {
+            if (!((moves >> dir) & 1)) continue;
+
+            size_t mark = cells->size;
+            int came = dir;
+            int cur = step(m, g->node_cell[u], dir);
+            while (!is_node(g, cur)) {
+                if (list_push(cells, cur)) return 1;
+                came = __builtin_ctz(open_moves(m, cur) & ~(1u << opposite(came)));
+                cur = step(m, cur, came);
+            }
+
+            int v = node_id(g, cur);
+            if (v <= u) {
+                cells->size = mark;
+                continue;
+            }
+            if (list_push(eu, u) || list_push(ev, v) || list_push(cstart, (int) mark)) return 1;
+        }
+    }
+    return list_push(cstart, (int) cells->size);
+}
+
+struct graph *graph_build(const struct maze *m) {
+    size_t cells = maze_cells(m);
+    struct graph *g = calloc(1, sizeof(struct graph));
+    if (!g) {
+        return NULL;
+    }
+    g->m = m;
+
+    struct int_list nodes = { NULL, 0, 0 }, eu = { NULL, 0, 0 }, ev = { NULL, 0, 0 };
+    struct int_list cstart = { NULL, 0, 0 }, corridor = { NULL, 0, 0 };
+
+    g->node_bits = calloc((cells + WORD_BITS - 1) / WORD_BITS, sizeof(uint64_t));
+    int err = !g->node_bits || find_nodes(g, &nodes);
+    if (!err) {
+        g->node_cell = nodes.data;
+        g->n_nodes = (int) nodes.size;
+        nodes.data = NULL;
+        err = trace_edges(g, &eu, &ev, &cstart, &corridor);
+    }
+    if (!err) {
+        g->edge_u = eu.data;
+        g->edge_v = ev.data;
+        g->cell_start = cstart.data;
+        g->cells = corridor.data;
+        g->n_edges = (int) eu.size;
+        eu.data = ev.data = cstart.data = corridor.data = NULL;
+        err = adjacency_build(g->n_nodes, g->n_edges, g->edge_u, g->edge_v, NULL, true, &g->adj_start,
+                              &g->adj_node, &g->adj_edge);
+    }
+
+    free(nodes.data);
+    free(eu.data);
+    free(ev.data);
+    free(cstart.data);
+    free(corridor.data);
+    if (err) {
+        graph_cleanup(g);
+        return NULL;
+    }
+    return g;
+}
+
+void graph_cleanup(struct graph *g) {
+    if (g == NULL) return;
+    free(g->node_cell);
+    free(g->node_bits);
+    free(g->adj_start);
+    free(g->adj_node);
+    free(g->adj_edge);
+    free(g->edge_u);
+    free(g->edge_v);
+    free(g->cell_start);
+    free(g->cells);
+    free(g);
+}
+
+int graph_nodes(const struct graph *g) {
+    return g->n_nodes;
+}
+
+int graph_edges(const struct graph *g) {
+    return g->n_edges;
+}
+
+struct graph_search *graph_search_init(const struct graph *g) {
+    size_t n = (size_t) g->n_nodes + 1;
+    struct graph_search *s = calloc(1, sizeof(struct graph_search));
+    if (!s) {
+        return NULL;
+    }
+
+    s->g = g;
+    s->heap = iheap_init(n);
+    s->dist = malloc(sizeof(int) * n);
+    s->prev_edge = malloc(sizeof(int) * n);
+    s->touched = malloc(sizeof(int) * n);
+    if (!s->heap || !s->dist || !s->prev_edge || !s->touched) {
+        graph_search_cleanup(s);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        s->dist[i] = -1;
+    }
+    s->length = NOT_FOUND;
+    return s;
+}
+
+void graph_search_measure(struct graph_search *s, struct metrics *mt) {
+    s->mt = mt;
+}
+
+void graph_search_cleanup(struct graph_search *s) {
+    if (s == NULL) return;
+    iheap_cleanup(s->heap);
+    free(s->dist);
+    free(s->prev_edge);
+    free(s->touched);
+    free(s);
+}
+
+/**
+ * Walks along a corridor from cell 'from' in direction 'dir' until it reaches a node, the cell
+ * 'stop', or 'from' again (a corridor loop without nodes).
+ *
+ * g: graph.
+ * from: cell to start from, not included in the walk.
+ * dir: direction of the first step.
+ * stop: cell to stop at, -1 for none.
+ * steps: receives the number of moves of the walk.
+ * paint: maze to mark the cells of the walk in with PATH, or NULL.
+ *
+ * Returns:
+ * the cell where the walk ended.
+*/
+static int walk(const struct graph *g, int from, int dir, int stop, int *steps, struct maze *paint) {
+    const struct maze *m = g->m;
+    int came = dir;
+    int cur = step(m, from, dir);
+    int n = 1;
+
+    for (;;) {
+        if (paint) {
+            maze_set(paint, maze_row(m, cur), maze_col(m, cur), PATH);
+        }
+        if (cur == stop || cur == from || is_node(g, cur)) break;
+
+        came = __builtin_ctz(open_moves(m, cur) & ~(1u << opposite(came)));
+        cur = step(m, cur, came);
+        n++;
+    }
+
+    *steps = n;
+    return cur;
+}
+
+/**
+ * Finds the nodes a query cell is attached to: the cell itself if it is a node, otherwise the
+ * nodes at both ends of its corridor. If the walk along the corridor meets 'other' first, the
+ * direct distance is recorded instead.
+ *
+ * s: search.
+ * cell: query cell.
+ * other: the other query cell.
+ * ends: receives up to MAX_ENDS nodes with their distance from 'cell'.
+ * direct: lowest direct distance to 'other' so far, updated.
+ * direct_dir: receives the direction of the direct walk, if 'direct' was lowered.
+ *
+ * Returns:
+ * the number of nodes found.
+*/
+static int find_ends(struct graph_search *s, int cell, int other, struct end *ends, int *direct,
+                     int *direct_dir) {
+    const struct graph *g = s->g;
+
+    if (is_node(g, cell)) {
+        ends[0].node = node_id(g, cell);
+        ends[0].off = 0;
+        ends[0].dir = NO_DIR;
+        return 1;
+    }
+
+    int n_ends = 0;
+    unsigned moves = open_moves(g->m, cell);
+    for (int dir = 0; dir < N_MOVES && n_ends < MAX_ENDS; dir++) {
+        if (!((moves >> dir) & 1)) continue;
+
+        int steps;
+        int end = walk(g, cell, dir, other, &steps, NULL);
+        if (end == other && !is_node(g, end)) {
+            if (steps < *direct) {
+                *direct = steps;
+                *direct_dir = dir;
+            }
+        } else if (end != cell) {
+            ends[n_ends].node = node_id(g, end);
+            ends[n_ends].off = steps;
+            ends[n_ends].dir = dir;
+            n_ends++;
+        }
+    }
+    return n_ends;
+}
+
+/* Sets the distance of node 'v' reached over 'edge' and queues it. */
+static int relax(struct graph_search *s, int v, int d, int edge) {
+    if (s->dist[v] == -1) {
+        s->touched[s->n_touched++] = v;
+    } else if (s->dist[v] <= d) {
+        return 0;
+    }
+    s->dist[v] = d;
+    s->prev_edge[v] = edge;
+    return iheap_push(s->heap, v, (uint64_t) d);
+}
+
+/* Resets the scratch buffers touched by the previous query. */
+static void reset(struct graph_search *s) {
+    for (int i = 0; i < s->n_touched; i++) {
+        s->dist[s->touched[i]] = -1;
+    }
+    s->n_touched = 0;
+    while (!iheap_empty(s->heap)) {
+        iheap_pop(s->heap);
+    }
+}
+
+/* Returns the number of bytes allocated by graph 'g'. */
+static size_t graph_bytes(const struct graph *g) {
+    size_t nodes = (size_t) g->n_nodes, edges = (size_t) g->n_edges;
+    size_t words = (maze_cells(g->m) + WORD_BITS - 1) / WORD_BITS;
+
+    return sizeof(uint64_t) * words
+           + sizeof(int) * (2 * nodes + 1 + 4 * (edges + 1) + 3 * edges + 1 + (size_t) g->cell_start[edges]);
+}
+
+/**
+ * Runs Dijkstra's algorithm from the source ends until no shorter path to a destination end can
+ * be found.
+ *
+ * s: search.
+ * src, n_src: source nodes with their distance from the start.
+ * dst, n_dst: destination nodes with their distance to the destination.
+ * best: length of the best path so far, updated.
+ *
+ * Returns:
+ * the index in 'dst' of the end of the best path, -1 if no path beat 'best', or ERROR.
+*/
+static int dijkstra(struct graph_search *s, const struct end *src, int n_src, const struct end *dst,
+                    int n_dst, int *best) {
+    const struct graph *g = s->g;
+    int best_end = -1;
+
+    for (int i = 0; i < n_src; i++) {
+        if (relax(s, src[i].node, src[i].off, NO_EDGE)) return ERROR;
+    }
+
+    while (!iheap_empty(s->heap)) {
+        int u = iheap_pop(s->heap);
+        int du = s->dist[u];
+        if (du >= *best) break;
+        if (s->mt && metrics_expand(s->mt, du, iheap_size(s->heap) + 1)) return ERROR;
+
+        for (int i = 0; i < n_dst; i++) {
+            if (dst[i].node == u && du + dst[i].off < *best) {
+                *best = du + dst[i].off;
+                best_end = i;
+            }
+        }
+
+        for (int a = g->adj_start[u]; a < g->adj_start[u + 1]; a++) {
+            int e = g->adj_edge[a];
+            if (relax(s, g->adj_node[a], du + edge_weight(g, e), e)) return ERROR;
+        }
+    }
+
+    return best_end;
+}
+
+int graph_query(struct graph_search *s, int start, int dest) {
+    const struct graph *g = s->g;
+    struct end src[MAX_ENDS], dst[MAX_ENDS];
+    int best = INT_MAX, direct_dir = NO_DIR;
+
+    reset(s);
+    s->start = start;
+    s->dest = dest;
+    s->length = NOT_FOUND;
+
+    if (!maze_walkable(g->m, maze_row(g->m, start), maze_col(g->m, start))
+        || !maze_walkable(g->m, maze_row(g->m, dest), maze_col(g->m, dest))) {
+        return NOT_FOUND;
+    }
+    if (start == dest) {
+        s->direct_dir = NO_DIR;
+        s->length = 0;
+        return 0;
+    }
+
+    /* A direct walk only exists inside a single corridor, so it is found from the start. */
+    int n_src = find_ends(s, start, dest, src, &best, &direct_dir);
+    int unused_dir = NO_DIR, unused_best = INT_MAX;
+    int n_dst = find_ends(s, dest, start, dst, &unused_best, &unused_dir);
+
+    int end = dijkstra(s, src, n_src, dst, n_dst, &best);
+    if (s->mt) {
+        s->mt->bytes = graph_bytes(g) + iheap_bytes(s->heap) + 3 * sizeof(int) * ((size_t) g->n_nodes + 1);
+    }
+    if (end == ERROR) return ERROR;
+    if (best == INT_MAX) return NOT_FOUND;
+
+    s->direct_dir = NO_DIR;
+    if (end < 0) {
+        s->direct_dir = direct_dir;
+    } else {
+        s->dst = dst[end];
+
+        /* Follow the edges back to the source node this path started from. */
+        int u = dst[end].node;
+        while (s->prev_edge[u] != NO_EDGE) {
+            int e = s->prev_edge[u];
+            u = g->edge_u[e] == u ? g->edge_v[e] : g->edge_u[e];
+        }
+        for (int i = 0; i < n_src; i++) {
+            if (src[i].node == u && src[i].off == s->dist[u]) {
+                s->src = src[i];
+            }
+        }
+    }
+
+    s->length = best;
+    return best;
+}
+
+void graph_paint(const struct graph_search *s, struct maze *m) {
+    const struct graph *g = s->g;
+    int steps;
+
+    if (s->length <= 0) return;
+
+    if (s->direct_dir != NO_DIR) {
+        walk(g, s->start, s->direct_dir, s->dest, &steps, m);
+        return;
+    }
+
+    if (s->src.dir != NO_DIR) {
+        walk(g, s->start, s->src.dir, -1, &steps, m);
+    }
+    if (s->dst.dir != NO_DIR) {
+        walk(g, s->dest, s->dst.dir, -1, &steps, m);
+    }
+
+    int u = s->dst.node;
+    maze_set(m, maze_row(m, g->node_cell[u]), maze_col(m, g->node_cell[u]), PATH);
+    while (s->prev_edge[u] != NO_EDGE) {
+        int e = s->prev_edge[u];
+        for (int i = g->cell_start[e]; i < g->cell_start[e + 1]; i++) {
+            maze_set(m, maze_row(m, g->cells[i]), maze_col(m, g->cells[i]), PATH);
+        }
+        u = g->edge_u[e] == u ? g->edge_v[e] : g->edge_u[e];
+        maze_set(m, maze_row(m, g->node_cell[u]), maze_col(m, g->node_cell[u]), PATH);
+    }
+
+    /* The start is only painted when it is the first node of the path. */
+    maze_set(m, maze_row(m, s->start), maze_col(m, s->start), FLOOR);
+    maze_set(m, maze_row(m, s->dest), maze_col(m, s->dest), PATH);
+}
@@ -0,0 +1,57 @@
+#ifndef _GRAPH_H_
+#define _GRAPH_H_
+
+#include <stdbool.h>
+
+#include "maze.h"
+#include "metrics.h"
+#include "solver.h"
+
+/* Handle to the junction graph of a maze */
+struct graph;
+
+/* Handle to the scratch buffers of a search on a junction graph */
+struct graph_search;
+
+/* Builds the junction graph of maze 'm'. Every open cell that does not have
+ * exactly two open neighbors (junctions and dead ends) becomes a node, and
+ * every corridor between two nodes becomes an edge weighted with its length.
+ * The graph only depends on the walls of 'm', which must not change while the
+ * graph is in use.
+ * Returns a pointer to the graph or NULL if an error occured. */
+struct graph *graph_build(const struct maze *m);
+
+/* Frees all memory associated with the graph. */
+void graph_cleanup(struct graph *g);
+
+/* Returns the number of nodes of the graph. */
+int graph_nodes(const struct graph *g);
+
+/* Returns the number of edges of the graph. */
+int graph_edges(const struct graph *g);
+
+/* Returns scratch buffers for repeated searches on 'g', or NULL if an error
+ * occured. A search only resets the parts of the buffers it touched. */
+struct graph_search *graph_search_init(const struct graph *g);
+
+/* Measures the following queries of 's' into 'mt', or stops measuring if
+ * 'mt' is NULL. A node counts as expanded at its distance from the start,
+ * and the bytes cover the graph and the scratch buffers.
+ * The corridor cells walked to connect a query to the graph are not counted. */
+void graph_search_measure(struct graph_search *s, struct metrics *mt);
+
+/* Frees the scratch buffers. */
+void graph_search_cleanup(struct graph_search *s);
+
+/* Finds the shortest path between the cells with maze indices 'start' and
+ * 'dest' with Dijkstra's algorithm on the graph. Cells inside a corridor are
+ * connected to the nodes at both ends of the corridor for this query.
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occured. */
+int graph_query(struct graph_search *s, int start, int dest);
+
+/* Marks every cell of the path found by the last successful graph_query()
+ * with PATH in 'm', except for the start cell. */
+void graph_paint(const struct graph_search *s, struct maze *m);
+
+#endif
@@ -0,0 +1,623 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program builds a hierarchical abstraction of a maze for hierarchical pathfinding (HPA*).
+ * The grid is cut into square clusters. Where two neighboring clusters share a run of open cells
+ * on both sides of their border (an entrance), the cells on both sides become transition nodes:
+ * one pair in the middle of a short entrance, or one pair at each end of a long one. The two
+ * nodes of a pair are joined by an edge of one move, and the nodes of a cluster are joined by
+ * edges weighted with their distance inside the cluster, found by a breadth-first search that
+ * never leaves the cluster. The abstract graph is stored in compressed sparse row (CSR) form,
+ * with the nodes of every cluster numbered together.
+ *
+ * A query connects the start and the destination to the nodes of their own cluster with one
+ * search inside each of these clusters, and runs A* on the small abstract graph. Only when the
+ * path is painted is it refined: each step between two nodes of a cluster is searched again
+ * inside that cluster. A path can only cross a border at transition nodes, so it may be a few
+ * moves longer than the shortest path, but every entrance has a node, so a path is always found
+ * when one exists.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "adjacency.h"
+#include "hpa.h"
+#include "iheap.h"
+
+#define WORD_BITS 64
+#define NO_NODE -1
+
+/* Entrances of at least this many cells get a pair of nodes at both ends. */
+#define ENTRANCE_SPLIT 6
+
+struct hpa {
+    const struct maze *m;
+    int n;
+    int size;
+    int per_side;
+    int n_nodes;
+    int n_edges;
+    int *node_cell;
+    int *cluster_start;
+    int *adj_start;
+    int *adj_node;
+    int *adj_weight;
+};
+
+/* Breadth-first search buffers for one cluster, indexed by the position of a cell in it. */
+struct local {
+    int r0;
+    int c0;
+    int r1;
+    int c1;
+    int *dist;
+    unsigned char *dir;
+    int *queue;
+};
+
+struct hpa_search {
+    const struct hpa *h;
+    struct iheap *heap;
+    int *g;
+    int *prev;
+    int *touched;
+    int n_touched;
+    struct local src;
+    struct local dst;
+
+    /* Route of the last query: the cells of its nodes from start to destination. */
+    int *route;
+    int route_len;
+    int start;
+    int dest;
+    int length;
+
+    /* Measurements of the queries, or NULL. */
+    struct metrics *mt;
+};
+
+/* Compares two integers for qsort(). */
+static int compare_int(const void *a, const void *b) {
+    int x = *(const int *) a, y = *(const int *) b;
+    return (x > y) - (x < y);
+}
+
+/* Returns the cluster of cell (r, c). */
+static int cluster_of(const struct hpa *h, int r, int c) {
+    return r / h->size * h->per_side + c / h->size;
+}
+
+/* Returns the cluster of the cell with maze index 'idx'. */
+static int cluster_of_cell(const struct hpa *h, int idx) {
+    return cluster_of(h, maze_row(h->m, idx), maze_col(h->m, idx));
+}
+
+/* Returns the node id of the node at cell 'idx' by binary search over the nodes of its cluster. */
+static int node_id(const struct hpa *h, int idx) {
+    int cl = cluster_of_cell(h, idx);
+    int lo = h->cluster_start[cl], hi = h->cluster_start[cl + 1] - 1;
+
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (h->node_cell[mid] < idx) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/* Allocates the buffers of 'l' for clusters of 'size' cells a side. Returns 1 if this failed. */
+static int local_init(struct local *l, int size) {
+    size_t cells = (size_t) size * (size_t) size;
+
+    l->dist = malloc(sizeof(int) * cells);
+    l->dir = malloc(cells);
+    l->queue = malloc(sizeof(int) * cells);
+    return !l->dist || !l->dir || !l->queue;
+}
+
+/* Frees the buffers of 'l'. */
+static void local_cleanup(struct local *l) {
+    free(l->dist);
+    free(l->dir);
+    free(l->queue);
+}
+
+/* Returns the position of cell (r, c) in the cluster searched by 'l'. */
+static int local_pos(const struct hpa *h, const struct local *l, int r, int c) {
+    return (r - l->r0) * h->size + (c - l->c0);
+}
+
+/* Returns the distance found by the last search of 'l' to the cell with maze index 'idx' in the
+ * same cluster, or -1 if it was not reached. */
+static int local_dist(const struct hpa *h, const struct local *l, int idx) {
+    return l->dist[local_pos(h, l, maze_row(h->m, idx), maze_col(h->m, idx))];
+}
+
+/**
+ * Runs a breadth-first search from cell 'from' that never leaves the cluster of 'from', and
+ * records the distance of every cell of the cluster and the direction it was entered from.
+ *
+ * h: abstraction.
+ * l: buffers that receive the result.
+ * from: maze index of the first cell.
+*/
+static void cluster_bfs(const struct hpa *h, struct local *l, int from) {
+    const struct maze *m = h->m;
+    int r = maze_row(m, from), c = maze_col(m, from);
+    int head = 0, tail = 0;
+
+    l->r0 = r / h->size * h->size;
+    l->c0 = c / h->size * h->size;
+    l->r1 = l->r0 + h->size < h->n ? l->r0 + h->size : h->n;
+    l->c1 = l->c0 + h->size < h->n ? l->c0 + h->size : h->n;
+    for (int i = 0; i < h->size * h->size; i++) {
+        l->dist[i] = -1;
+    }
+
+    l->dist[local_pos(h, l, r, c)] = 0;
+    l->queue[tail++] = local_pos(h, l, r, c);
+    while (head < tail) {
+        int cur = l->queue[head++];
+        r = l->r0 + cur / h->size;
+        c = l->c0 + cur % h->size;
+
+        for (int dir = 0; dir < N_MOVES; dir++) {
+            int r_new = r + m_offsets[dir][0];
+            int c_new = c + m_offsets[dir][1];
+            if (r_new < l->r0 || r_new >= l->r1 || c_new < l->c0 || c_new >= l->c1) continue;
+
+            int pos = local_pos(h, l, r_new, c_new);
+            if (l->dist[pos] == -1 && maze_walkable(m, r_new, c_new)) {
+                l->dist[pos] = l->dist[cur] + 1;
+                l->dir[pos] = (unsigned char) dir;
+                l->queue[tail++] = pos;
+            }
+        }
+    }
+}
+
+/**
+ * Adds the transition nodes of one entrance: the pair of cells in the middle of the entrance,
+ * or the pairs at both of its ends if it is long.
+ *
+ * h: abstraction under construction.
+ * bits: bitmap of the cells that are already a node.
+ * nodes: list that receives new node cells.
+ * pairs: list that receives both cells of every transition.
+ * r, c: first cell of the entrance on the near side of the border.
+ * vertical: true if the border is vertical, so the entrance runs down.
+ * len: number of cells of the entrance.
+ *
+ * Returns:
+ * 0 if successful, 1 if memory could not be allocated.
+*/
+static int add_entrance(const struct hpa *h, uint64_t *bits, struct int_list *nodes, struct int_list *pairs,
+                        int r, int c, bool vertical, int len) {
+    int at[2] = { len / 2, len / 2 };
+    if (len >= ENTRANCE_SPLIT) {
+        at[0] = 0;
+        at[1] = len - 1;
+    }
+
+    for (int i = 0; i < 2; i++) {
+        if (i == 1 && at[1] == at[0]) break;
+
+        int r_near = vertical ? r + at[i] : r;
+        int c_near = vertical ? c : c + at[i];
+        int cell[2] = { maze_index(h->m, r_near, c_near),
+                        maze_index(h->m, r_near + !vertical, c_near + vertical) };
+
+        for (int j = 0; j < 2; j++) {
+            uint64_t bit = (uint64_t) 1 << (cell[j] % WORD_BITS);
+            if (!(bits[cell[j] / WORD_BITS] & bit)) {
+                bits[cell[j] / WORD_BITS] |= bit;
+                if (list_push(nodes, cell[j])) return 1;
+            }
+            if (list_push(pairs, cell[j])) return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Finds the entrances on all borders between neighboring clusters and adds their transitions.
+ * An entrance is a run of cells along one border, between two clusters only, that are open on
+ * both sides.
+ *
+ * h: abstraction under construction.
+ * bits: bitmap of the cells that are already a node.
+ * nodes: list that receives the node cells.
+ * pairs: list that receives both cells of every transition.
+ *
+ * Returns:
+ * 0 if successful, 1 if memory could not be allocated.
+*/
+static int find_transitions(const struct hpa *h, uint64_t *bits, struct int_list *nodes,
+                            struct int_list *pairs) {
+    const struct maze *m = h->m;
+
+    for (int vertical = 0; vertical < 2; vertical++) {
+        /* 'line' is the first row or column past a border, 'along' runs parallel to it. */
+        for (int line = h->size; line < h->n; line += h->size) {
+            int run = 0;
+            for (int along = 0; along <= h->n; along++) {
+                int r = vertical ? along : line - 1;
+                int c = vertical ? line - 1 : along;
+                bool open = along < h->n && maze_walkable(m, r, c)
+                            && maze_walkable(m, r + !vertical, c + vertical);
+
+                /* An entrance ends where the cells close or the next cluster begins. */
+                if (run > 0 && (!open || along % h->size == 0)) {
+                    int first = along - run;
+                    if (add_entrance(h, bits, nodes, pairs, vertical ? first : r, vertical ? c : first,
+                                     vertical, run)) {
+                        return 1;
+                    }
+                    run = 0;
+                }
+                run += open;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * Numbers the nodes by cluster and by cell within a cluster, and fills the cluster starts.
+ *
+ * h: abstraction under construction.
+ * nodes: node cells in any order.
+ *
+ * Returns:
+ * 0 if successful, 1 if memory could not be allocated.
+*/
+static int order_nodes(struct hpa *h, const struct int_list *nodes) {
+    int clusters = h->per_side * h->per_side;
+
+    h->n_nodes = (int) nodes->size;
+    h->node_cell = malloc(sizeof(int) * (nodes->size + 1));
+    h->cluster_start = calloc((size_t) clusters + 1, sizeof(int));
+    if (!h->node_cell || !h->cluster_start) return 1;
+
+    for (size_t i = 0; i < nodes->size; i++) {
+        h->cluster_start[cluster_of_cell(h, nodes->data[i]) + 1]++;
+    }
+    for (int cl = 0; cl < clusters; cl++) {
+        h->cluster_start[cl + 1] += h->cluster_start[cl];
+    }
+
+    /* Fill using cluster_start[cl] as insert position, then shift the starts back. */
+    for (size_t i = 0; i < nodes->size; i++) {
+        h->node_cell[h->cluster_start[cluster_of_cell(h, nodes->data[i])]++] = nodes->data[i];
+    }
+    for (int cl = clusters; cl > 0; cl--) {
+        h->cluster_start[cl] = h->cluster_start[cl - 1];
+    }
+    h->cluster_start[0] = 0;
+
+    for (int cl = 0; cl < clusters; cl++) {
+        qsort(h->node_cell + h->cluster_start[cl], (size_t) (h->cluster_start[cl + 1] - h->cluster_start[cl]),
+              sizeof(int), compare_int);
+    }
+    return 0;
+}
+
+/* Appends the edge from 'u' to 'v' with weight 'w' to the edge lists. Returns 1 if this failed. */
+static int push_edge(struct int_list *eu, struct int_list *ev, struct int_list *ew, int u, int v, int w) {
+    return list_push(eu, u) || list_push(ev, v) || list_push(ew, w);
+}
+
+/**
+ * Collects the edges of the abstraction in both directions: one move between the nodes of every
+ * transition, and the distance inside the cluster between every two nodes of a cluster that
+ * can reach each other there.
+ *
+ * h: abstraction under construction, with its nodes.
+ * pairs: both cells of every transition.
+ * eu, ev, ew: lists that receive the start, end and weight of every edge.
+ *
+ * Returns:
+ * 0 if successful, 1 if memory could not be allocated.
+*/
+static int collect_edges(const struct hpa *h, const struct int_list *pairs, struct int_list *eu,
+                         struct int_list *ev, struct int_list *ew) {
+    struct local l;
+    int err = local_init(&l, h->size);
+
+    for (size_t i = 0; !err && i + 1 < pairs->size; i += 2) {
+        int u = node_id(h, pairs->data[i]), v = node_id(h, pairs->data[i + 1]);
+        err = push_edge(eu, ev, ew, u, v, 1) || push_edge(eu, ev, ew, v, u, 1);
+    }
+
+    for (int cl = 0; !err && cl < h->per_side * h->per_side; cl++) {
+        for (int u = h->cluster_start[cl]; !err && u < h->cluster_start[cl + 1]; u++) {
+            cluster_bfs(h, &l, h->node_cell[u]);
+            for (int v = h->cluster_start[cl]; !err && v < h->cluster_start[cl + 1]; v++) {
+                int d = local_dist(h, &l, h->node_cell[v]);
+                if (d > 0) {
+                    err = push_edge(eu, ev, ew, u, v, d);
+                }
+            }
+        }
+    }
+
+    local_cleanup(&l);
+    return err;
+}
+
+struct hpa *hpa_build(const struct maze *m, int cluster_size) {
+    if (cluster_size < 1) {
+        return NULL;
+    }
+    struct hpa *h = calloc(1, sizeof(struct hpa));
+    if (!h) {
+        return NULL;
+    }
+    h->m = m;
+    h->n = maze_size(m);
+    h->size = cluster_size < h->n ? cluster_size : h->n;
+    h->per_side = (h->n + h->size - 1) / h->size;
+
+    struct int_list nodes = { NULL, 0, 0 }, pairs = { NULL, 0, 0 };
+    struct int_list eu = { NULL, 0, 0 }, ev = { NULL, 0, 0 }, ew = { NULL, 0, 0 };
+
+    uint64_t *bits = calloc((maze_cells(m) + WORD_BITS - 1) / WORD_BITS, sizeof(uint64_t));
+    int err = !bits || find_transitions(h, bits, &nodes, &pairs) || order_nodes(h, &nodes)
+              || collect_edges(h, &pairs, &eu, &ev, &ew);
+    if (!err) {
+        h->n_edges = (int) eu.size;
+        err = adjacency_build(h->n_nodes, h->n_edges, eu.data, ev.data, ew.data, false, &h->adj_start,
+                              &h->adj_node, &h->adj_weight);
+    }
+
+    free(bits);
+    free(nodes.data);
+    free(pairs.data);
+    free(eu.data);
+    free(ev.data);
+    free(ew.data);
+    if (err) {
+        hpa_cleanup(h);
+        return NULL;
+    }
+    return h;
+}
+
+void hpa_cleanup(struct hpa *h) {
+    if (h == NULL) return;
+    free(h->node_cell);
+    free(h->cluster_start);
+    free(h->adj_start);
+    free(h->adj_node);
+    free(h->adj_weight);
+    free(h);
+}
+
+int hpa_nodes(const struct hpa *h) {
+    return h->n_nodes;
+}
+
+int hpa_edges(const struct hpa *h) {
+    return h->n_edges;
+}
+
+struct hpa_search *hpa_search_init(const struct hpa *h) {
+    /* Two extra nodes stand for the start and the destination of a query. */
+    size_t n = (size_t) h->n_nodes + 2;
+    struct hpa_search *s = calloc(1, sizeof(struct hpa_search));
+    if (!s) {
+        return NULL;
+    }
+
+    s->h = h;
+    s->heap = iheap_init(n);
+    s->g = malloc(sizeof(int) * n);
+    s->prev = malloc(sizeof(int) * n);
+    s->touched = malloc(sizeof(int) * n);
+    s->route = malloc(sizeof(int) * n);
+    int err = local_init(&s->src, h->size) | local_init(&s->dst, h->size);
+    if (err || !s->heap || !s->g || !s->prev || !s->touched || !s->route) {
+        hpa_search_cleanup(s);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        s->g[i] = -1;
+    }
+    s->length = NOT_FOUND;
+    return s;
+}
+
+void hpa_search_measure(struct hpa_search *s, struct metrics *mt) {
+    s->mt = mt;
+}
+
+void hpa_search_cleanup(struct hpa_search *s) {
+    if (s == NULL) return;
+    iheap_cleanup(s->heap);
+    free(s->g);
+    free(s->prev);
+    free(s->touched);
+    free(s->route);
+    local_cleanup(&s->src);
+    local_cleanup(&s->dst);
+    free(s);
+}
+
+/* Returns the Manhattan distance from the cell with maze index 'idx' to the destination. */
+static int heuristic(const struct hpa_search *s, int idx) {
+    const struct maze *m = s->h->m;
+    return abs(maze_row(m, idx) - maze_row(m, s->dest)) + abs(maze_col(m, idx) - maze_col(m, s->dest));
+}
+
+/* Returns the cell of node 'u', where the extra nodes are the start and the destination. */
+static int node_cell(const struct hpa_search *s, int u) {
+    if (u == s->h->n_nodes) return s->start;
+    if (u == s->h->n_nodes + 1) return s->dest;
+    return s->h->node_cell[u];
+}
+
+/* Sets the distance of node 'v' reached from node 'u' and queues it. Ties in f = g + h are broken
+ * towards the lower h, like the A* solver does. */
+static int relax(struct hpa_search *s, int v, int d, int u) {
+    if (s->g[v] == -1) {
+        s->touched[s->n_touched++] = v;
+    } else if (s->g[v] <= d) {
+        return 0;
+    }
+    s->g[v] = d;
+    s->prev[v] = u;
+
+    uint64_t h = (uint64_t) heuristic(s, node_cell(s, v));
+    return iheap_push(s->heap, v, ((uint64_t) d + h) << 32 | h);
+}
+
+/* Resets the scratch buffers touched by the previous query. */
+static void reset(struct hpa_search *s) {
+    for (int i = 0; i < s->n_touched; i++) {
+        s->g[s->touched[i]] = -1;
+    }
+    s->n_touched = 0;
+    while (!iheap_empty(s->heap)) {
+        iheap_pop(s->heap);
+    }
+}
+
+/**
+ * Runs A* from the start over the abstract graph until the destination is expanded. The start
+ * is connected to the nodes of its cluster, and to the destination if it lies in the same
+ * cluster; the nodes of the cluster of the destination are connected to it.
+ *
+ * s: search, with the start and destination set.
+ *
+ * Returns:
+ * 0 if successful, 1 if the heap or the level histogram could not grow.
+*/
+static int astar(struct hpa_search *s) {
+    const struct hpa *h = s->h;
+    int source = h->n_nodes, target = h->n_nodes + 1;
+    int src_cl = cluster_of_cell(h, s->start), dst_cl = cluster_of_cell(h, s->dest);
+
+    cluster_bfs(h, &s->src, s->start);
+    cluster_bfs(h, &s->dst, s->dest);
+
+    s->g[source] = 0;
+    s->prev[source] = NO_NODE;
+    s->touched[s->n_touched++] = source;
+    for (int v = h->cluster_start[src_cl]; v < h->cluster_start[src_cl + 1]; v++) {
+        int d = local_dist(h, &s->src, h->node_cell[v]);
+        if (d >= 0 && relax(s, v, d, source)) return 1;
+    }
+    if (src_cl == dst_cl && local_dist(h, &s->src, s->dest) >= 0
+        && relax(s, target, local_dist(h, &s->src, s->dest), source)) {
+        return 1;
+    }
+
+    while (!iheap_empty(s->heap)) {
+        int u = iheap_pop(s->heap);
+        if (s->mt && metrics_expand(s->mt, s->g[u], iheap_size(s->heap) + 1)) return 1;
+        if (u == target) break;
+
+        int gu = s->g[u];
+        if (cluster_of_cell(h, h->node_cell[u]) == dst_cl) {
+            int d = local_dist(h, &s->dst, h->node_cell[u]);
+            if (d >= 0 && relax(s, target, gu + d, u)) return 1;
+        }
+        for (int a = h->adj_start[u]; a < h->adj_start[u + 1]; a++) {
+            if (relax(s, h->adj_node[a], gu + h->adj_weight[a], u)) return 1;
+        }
+    }
+    return 0;
+}
+
+/* Returns the number of bytes allocated by abstraction 'h'. */
+static size_t hpa_bytes(const struct hpa *h) {
+    size_t clusters = (size_t) h->per_side * (size_t) h->per_side;
+    return sizeof(int) * (2 * (size_t) h->n_nodes + 2 + clusters + 1 + 2 * ((size_t) h->n_edges + 1));
+}
+
+/* Returns the number of bytes allocated by search 's', its two cluster searches included. */
+static size_t search_bytes(const struct hpa_search *s) {
+    size_t cluster_cells = (size_t) s->h->size * (size_t) s->h->size;
+    return iheap_bytes(s->heap) + 4 * sizeof(int) * ((size_t) s->h->n_nodes + 2)
+           + 2 * (2 * sizeof(int) + 1) * cluster_cells;
+}
+
+int hpa_query(struct hpa_search *s, int start, int dest) {
+    const struct hpa *h = s->h;
+    const struct maze *m = h->m;
+
+    reset(s);
+    s->start = start;
+    s->dest = dest;
+    s->length = NOT_FOUND;
+    s->route_len = 0;
+
+    if (!maze_walkable(m, maze_row(m, start), maze_col(m, start))
+        || !maze_walkable(m, maze_row(m, dest), maze_col(m, dest))) {
+        return NOT_FOUND;
+    }
+    if (start == dest) {
+        s->route[s->route_len++] = start;
+        s->length = 0;
+        return 0;
+    }
+
+    int err = astar(s);
+    if (s->mt) {
+        s->mt->bytes = hpa_bytes(h) + search_bytes(s);
+    }
+    if (err) return ERROR;
+    int target = h->n_nodes + 1;
+    if (s->g[target] == -1) return NOT_FOUND;
+
+    /* Follow the nodes back to the start, then put them in order. */
+    for (int u = target; u != NO_NODE; u = s->prev[u]) {
+        s->route[s->route_len++] = node_cell(s, u);
+    }
+    for (int i = 0, j = s->route_len - 1; i < j; i++, j--) {
+        int tmp = s->route[i];
+        s->route[i] = s->route[j];
+        s->route[j] = tmp;
+    }
+
+    s->length = s->g[target];
+    return s->length;
+}
+
+void hpa_paint(struct hpa_search *s, struct maze *m) {
+    const struct hpa *h = s->h;
+
+    if (s->length <= 0) return;
+
+    for (int i = 1; i < s->route_len; i++) {
+        int from = s->route[i - 1], to = s->route[i];
+        int r = maze_row(m, to), c = maze_col(m, to);
+
+        /* Nodes in different clusters are the two sides of a transition, one move apart. */
+        if (cluster_of_cell(h, from) != cluster_of_cell(h, to)) {
+            maze_set(m, r, c, PATH);
+            continue;
+        }
+
+        /* Refine the step inside its cluster and walk back from its end. */
+        cluster_bfs(h, &s->src, from);
+        while (!(r == maze_row(m, from) && c == maze_col(m, from))) {
+            int dir = s->src.dir[local_pos(h, &s->src, r, c)];
+            maze_set(m, r, c, PATH);
+            r -= m_offsets[dir][0];
+            c -= m_offsets[dir][1];
+        }
+    }
+
+    /* A longer route may pass the start again, which is never painted. */
+    maze_set(m, maze_row(m, s->start), maze_col(m, s->start), FLOOR);
+}
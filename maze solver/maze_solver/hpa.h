@@ -0,0 +1,63 @@
+#ifndef _HPA_H_
+#define _HPA_H_
+
+#include "maze.h"
+#include "metrics.h"
+#include "solver.h"
+
+/* Cluster size used when none is given. */
+#define HPA_CLUSTER_SIZE 16
+
+/* Handle to the cluster abstraction of a maze */
+struct hpa;
+
+/* Handle to the scratch buffers of a search on a cluster abstraction */
+struct hpa_search;
+
+/* Builds the abstraction of maze 'm' with square clusters of 'cluster_size'
+ * cells a side. Every entrance between two neighboring clusters gets one or
+ * two pairs of transition nodes, and the nodes of a cluster are connected by
+ * edges weighted with their distance inside the cluster. The abstraction
+ * only depends on the walls of 'm', which must not change while it is in
+ * use.
+ * Returns a pointer to the abstraction or NULL if an error occured. */
+struct hpa *hpa_build(const struct maze *m, int cluster_size);
+
+/* Frees all memory associated with the abstraction. */
+void hpa_cleanup(struct hpa *h);
+
+/* Returns the number of transition nodes of the abstraction. */
+int hpa_nodes(const struct hpa *h);
+
+/* Returns the number of edges of the abstraction, in both directions. */
+int hpa_edges(const struct hpa *h);
+
+/* Returns scratch buffers for repeated searches on 'h', or NULL if an error
+ * occured. A search only resets the parts of the buffers it touched. */
+struct hpa_search *hpa_search_init(const struct hpa *h);
+
+/* Measures the following queries of 's' into 'mt', or stops measuring if
+ * 'mt' is NULL. A node of the abstract graph counts as expanded at its
+ * distance from the start, and the bytes cover the abstraction and the
+ * scratch buffers. The searches inside the clusters of the start and the
+ * destination and the refinement of the path are not counted. */
+void hpa_search_measure(struct hpa_search *s, struct metrics *mt);
+
+/* Frees the scratch buffers. */
+void hpa_search_cleanup(struct hpa_search *s);
+
+/* Finds a path between the cells with maze indices 'start' and 'dest' with
+ * A* on the abstraction, after connecting both cells to the nodes of their
+ * cluster. As a path may only cross between clusters at transition nodes, it
+ * can be a little longer than the shortest path; it is found whenever one
+ * exists.
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occured. */
+int hpa_query(struct hpa_search *s, int start, int dest);
+
+/* Refines the path found by the last successful hpa_query() inside every
+ * cluster it passes through, and marks each of its cells with PATH in 'm',
+ * except for the start cell. */
+void hpa_paint(struct hpa_search *s, struct maze *m);
+
+#endif
@@ -0,0 +1,232 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program provides an indexed binary min-heap for the A* maze solver. The heap stores
+ * integer items, normally maze indices, together with a 64-bit key. Next to the heap array it
+ * keeps the position of every item in the heap, so an item that is already queued can get a
+ * lower key and be sifted up in place (decrease-key) instead of being pushed a second time, and
+ * any item can be taken out of the heap again.
+*/
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "iheap.h"
+
+#define INIT_SIZE 64
+#define LEFT_CHILD(i) (2 * (i) + 1)
+#define RIGHT_CHILD(i) (2 * (i) + 2)
+#define PARENT(i) (((i) - 1) / 2)
+#define NOT_QUEUED -1
+
+struct entry {
+    uint64_t key;
+    int item;
+};
+
+struct iheap {
+    size_t n_items;
+    size_t size;
+    size_t capacity;
+    struct entry *data;
+    int *pos;
+#ifdef CONTAINER_STATS
+    int pop_count;
+    int push_count;
+    size_t max_elem;
+#endif
+};
+
+struct iheap *iheap_init(size_t n_items) {
+    if (n_items > INT_MAX) {
+        return NULL;
+    }
+
+    struct iheap *h = malloc(sizeof(struct iheap));
+    if (h == NULL) {
+        return NULL;
+    }
+
+    h->data = malloc(sizeof(struct entry) * INIT_SIZE);
+    if (h->data == NULL) {
+        free(h);
+        return NULL;
+    }
+
+    h->pos = malloc(sizeof(int) * (n_items ? n_items : 1));
+    if (h->pos == NULL) {
+        free(h->data);
+        free(h);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < n_items; i++) {
+        h->pos[i] = NOT_QUEUED;
+    }
+
+    h->n_items = n_items;
+    h->size = 0;
+    h->capacity = INIT_SIZE;
+#ifdef CONTAINER_STATS
+    h->pop_count = 0;
+    h->push_count = 0;
+    h->max_elem = 0;
+#endif
+
+    return h;
+}
+
+void iheap_cleanup(struct iheap *h) {
+    if (h == NULL) return;
+    free(h->data);
+    free(h->pos);
+    free(h);
+}
+
+void iheap_stats(const struct iheap *h) {
+    if (h == NULL) return;
+#ifdef CONTAINER_STATS
+    fprintf(stderr, "stats %d %d %zu\n", h->push_count, h->pop_count, h->max_elem);
+#else
+    fprintf(stderr, "stats 0 0 0\n");
+#endif
+}
+
+size_t iheap_bytes(const struct iheap *h) {
+    if (h == NULL) return 0;
+    return sizeof(struct iheap) + sizeof(struct entry) * h->capacity
+           + sizeof(int) * (h->n_items ? h->n_items : 1);
+}
+
+/* Places entry 'e' at heap position 'i' and records the position of its item. */
+static void place(struct iheap *h, size_t i, struct entry e) {
+    h->data[i] = e;
+    h->pos[e.item] = (int) i;
+}
+
+/* Moves the entry at position 'i' up until its parent has a lower or equal key. */
+static void sift_up(struct iheap *h, size_t i) {
+    struct entry e = h->data[i];
+
+    while (i > 0 && h->data[PARENT(i)].key > e.key) {
+        place(h, i, h->data[PARENT(i)]);
+        i = PARENT(i);
+    }
+    place(h, i, e);
+}
+
+/* Moves the entry at position 'i' down until both children have a higher or equal key. */
+static void sift_down(struct iheap *h, size_t i) {
+    struct entry e = h->data[i];
+
+    while (LEFT_CHILD(i) < h->size) {
+        size_t child = LEFT_CHILD(i);
+        if (RIGHT_CHILD(i) < h->size && h->data[RIGHT_CHILD(i)].key < h->data[child].key) {
+            child = RIGHT_CHILD(i);
+        }
+        if (h->data[child].key >= e.key) break;
+
+        place(h, i, h->data[child]);
+        i = child;
+    }
+    place(h, i, e);
+}
+
+int iheap_push(struct iheap *h, int item, uint64_t key) {
+    if (h == NULL || item < 0 || (size_t) item >= h->n_items) return 1;
+
+    int i = h->pos[item];
+    if (i != NOT_QUEUED) {
+        if (key < h->data[i].key) {
+            h->data[i].key = key;
+            sift_up(h, (size_t) i);
+        }
+        return 0;
+    }
+
+    if (h->size == h->capacity) {
+        struct entry *data = realloc(h->data, sizeof(struct entry) * h->capacity * 2);
+        if (data == NULL) return 1;
+        h->data = data;
+        h->capacity *= 2;
+    }
+
+    h->data[h->size].key = key;
+    h->data[h->size].item = item;
+    h->size++;
+    sift_up(h, h->size - 1);
+#ifdef CONTAINER_STATS
+    h->push_count++;
+    if (h->size > h->max_elem) {
+        h->max_elem = h->size;
+    }
+#endif
+
+    return 0;
+}
+
+int iheap_pop(struct iheap *h) {
+    if (h == NULL || h->size == 0) return -1;
+
+    int item = h->data[0].item;
+    h->pos[item] = NOT_QUEUED;
+    h->size--;
+
+    if (h->size > 0) {
+        place(h, 0, h->data[h->size]);
+        sift_down(h, 0);
+    }
+#ifdef CONTAINER_STATS
+    h->pop_count++;
+#endif
+
+    return item;
+}
+
+int iheap_remove(struct iheap *h, int item) {
+    if (h == NULL || item < 0 || (size_t) item >= h->n_items) return 1;
+
+    int i = h->pos[item];
+    if (i == NOT_QUEUED) return 0;
+
+    h->pos[item] = NOT_QUEUED;
+    h->size--;
+
+    /* Fill the hole with the last entry, which may have to move either way. */
+    if ((size_t) i < h->size) {
+        struct entry last = h->data[h->size];
+        place(h, (size_t) i, last);
+        sift_up(h, (size_t) i);
+        sift_down(h, (size_t) h->pos[last.item]);
+    }
+    return 0;
+}
+
+uint64_t iheap_top_key(const struct iheap *h) {
+    if (h == NULL || h->size == 0) return UINT64_MAX;
+    return h->data[0].key;
+}
+
+bool iheap_contains(const struct iheap *h, int item) {
+    if (h == NULL || item < 0 || (size_t) item >= h->n_items) return false;
+    return h->pos[item] != NOT_QUEUED;
+}
+
+int iheap_empty(const struct iheap *h) {
+    if (h == NULL) {
+        return -1;
+    } else if (h->size == 0) {
+        return 1;
+    } else {
+        return 0;
+    }
+}
+
+size_t iheap_size(const struct iheap *h) {
+    if (h == NULL) return 0;
+    return h->size;
+}
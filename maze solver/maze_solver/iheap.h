@@ -0,0 +1,56 @@
+#ifndef _IHEAP_H_
+#define _IHEAP_H_
+
+/* Indexed binary min-heap over the integer items 0 .. n_items - 1, such as
+ * maze_index() values. Every item is at most once in the heap and its key
+ * can be lowered while it is queued (decrease-key). */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Handle to indexed heap */
+struct iheap;
+
+/* Return a pointer to an empty heap for the items 0 .. 'n_items' - 1 if
+ * successful, otherwise return NULL. */
+struct iheap *iheap_init(size_t n_items);
+
+/* Cleanup heap. */
+void iheap_cleanup(struct iheap *h);
+
+/* Print heap statistics to stderr.
+ * The format is: 'stats' num_of_pushes num_of_pops max_elements
+ * The counts are only kept when compiled with -DCONTAINER_STATS (make
+ * STATS=1), otherwise they are printed as 0. */
+void iheap_stats(const struct iheap *h);
+
+/* Return the number of bytes allocated by the heap, or 0 if 'h' is NULL. */
+size_t iheap_bytes(const struct iheap *h);
+
+/* Insert 'item' with 'key'. If the item is already in the heap and 'key' is
+ * lower than its current key, its key is decreased instead.
+ * Return 0 if successful, 1 otherwise. */
+int iheap_push(struct iheap *h, int item, uint64_t key);
+
+/* Remove the item with the lowest key from the heap and return it.
+ * Return the item if successful, -1 otherwise. */
+int iheap_pop(struct iheap *h);
+
+/* Remove 'item' from the heap if it is in it, wherever it is.
+ * Return 0 if successful, 1 otherwise. */
+int iheap_remove(struct iheap *h, int item);
+
+/* Return the lowest key in the heap, or UINT64_MAX if the heap is empty. */
+uint64_t iheap_top_key(const struct iheap *h);
+
+/* Return true if 'item' is currently in the heap. */
+bool iheap_contains(const struct iheap *h, int item);
+
+/* Return 1 if heap is empty, 0 if the heap contains any elements and
+ * return -1 if the operation fails. */
+int iheap_empty(const struct iheap *h);
+
+/* Return the number of elements stored in the heap. */
+size_t iheap_size(const struct iheap *h);
+
+#endif
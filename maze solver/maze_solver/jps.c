@@ -0,0 +1,250 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program provides Jump Point Search (JPS) for the four-connected maze. Open rooms have many
+ * shortest paths that only differ in the order of their moves. JPS only follows one of them: a
+ * path that moves horizontally may only turn up or down where it is forced to, that is where the
+ * cell above (or below) is open but the one diagonally behind it is a wall. A vertical move may
+ * branch left and right at every cell, so a vertical run stops at a cell as soon as a horizontal
+ * scan from it finds a jump point.
+ *
+ * A* then only expands jump points, with the distance between two jump points as the cost of
+ * the edge between them. Consecutive jump points on the path always lie on one row or column, so
+ * the cells between them are filled in with PATH at the end.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "iheap.h"
+#include "jps.h"
+
+#define UP 0
+#define RIGHT 1
+#define DOWN 2
+#define LEFT 3
+#define NO_JUMP -1
+
+struct jps {
+    struct maze *m;
+    int dest_r;
+    int dest_c;
+    struct metrics *mt;
+};
+
+/* Returns true if a horizontal move into (r, c) in direction 'dir' is forced to turn, because
+ * the cell above or below is open while the one diagonally behind it is a wall. */
+static bool forced_turn(const struct maze *m, int r, int c, int dir) {
+    int c_back = c - m_offsets[dir][1];
+
+    return (maze_walkable(m, r - 1, c) && !maze_walkable(m, r - 1, c_back))
+           || (maze_walkable(m, r + 1, c) && !maze_walkable(m, r + 1, c_back));
+}
+
+/**
+ * Scans from (r, c) in the horizontal direction 'dir' until it finds a jump point, which is the
+ * destination or a cell with a forced turn.
+ * 
+ * j: search state.
+ * r: row index.
+ * c: column index.
+ * dir: LEFT or RIGHT.
+ * 
+ * Returns:
+ * the index of the jump point, or NO_JUMP if the scan runs into a wall first.
+*/
+static int jump_horizontal(const struct jps *j, int r, int c, int dir) {
+    for (;;) {
+        c += m_offsets[dir][1];
+        if (!maze_walkable(j->m, r, c)) return NO_JUMP;
+        if (r == j->dest_r && c == j->dest_c) return maze_index(j->m, r, c);
+        if (forced_turn(j->m, r, c, dir)) return maze_index(j->m, r, c);
+    }
+}
+
+/**
+ * Scans from (r, c) in the vertical direction 'dir'. A cell of the run is a jump point if it is
+ * the destination or if one of the horizontal scans from it finds a jump point.
+ * 
+ * j: search state.
+ * r: row index.
+ * c: column index.
+ * dir: UP or DOWN.
+ * 
+ * Returns:
+ * the index of the jump point, or NO_JUMP if the scan runs into a wall first.
+*/
+static int jump_vertical(const struct jps *j, int r, int c, int dir) {
+    for (;;) {
+        r += m_offsets[dir][0];
+        if (!maze_walkable(j->m, r, c)) return NO_JUMP;
+        if (r == j->dest_r && c == j->dest_c) return maze_index(j->m, r, c);
+        if (jump_horizontal(j, r, c, LEFT) != NO_JUMP
+            || jump_horizontal(j, r, c, RIGHT) != NO_JUMP) {
+            return maze_index(j->m, r, c);
+        }
+    }
+}
+
+/**
+ * Determines the directions to search from a jump point, given the direction it was reached in.
+ * 
+ * m: maze.
+ * r: row index.
+ * c: column index.
+ * dir: direction the jump point was entered in, -1 for the start.
+ * 
+ * Returns:
+ * a mask with bit 'i' set if direction m_offsets[i] has to be searched.
+*/
+static unsigned successor_dirs(const struct maze *m, int r, int c, int dir) {
+    if (dir < 0) {
+        return 0xf;
+    }
+    if (dir == UP || dir == DOWN) {
+        return 1u << dir | 1u << LEFT | 1u << RIGHT;
+    }
+
+    unsigned dirs = 1u << dir;
+    int c_back = c - m_offsets[dir][1];
+    if (maze_walkable(m, r - 1, c) && !maze_walkable(m, r - 1, c_back)) dirs |= 1u << UP;
+    if (maze_walkable(m, r + 1, c) && !maze_walkable(m, r + 1, c_back)) dirs |= 1u << DOWN;
+    return dirs;
+}
+
+/* Returns the direction of the straight move from cell 'from' to cell 'to'. */
+static int direction(const struct maze *m, int from, int to) {
+    int dr = maze_row(m, to) - maze_row(m, from);
+    int dc = maze_col(m, to) - maze_col(m, from);
+
+    if (dr < 0) return UP;
+    if (dr > 0) return DOWN;
+    return dc > 0 ? RIGHT : LEFT;
+}
+
+/* Returns the Manhattan distance between cells 'a' and 'b'. */
+static int distance(const struct maze *m, int a, int b) {
+    return abs(maze_row(m, a) - maze_row(m, b)) + abs(maze_col(m, a) - maze_col(m, b));
+}
+
+/* Builds the heap key: f = g + h first, then the cell closest to the destination. */
+static uint64_t make_key(int g, int h) {
+    return (uint64_t) (g + h) << 32 | (uint32_t) h;
+}
+
+/**
+ * Draws the path by walking back over the jump points and filling in the straight runs of
+ * cells between them.
+ * 
+ * m: maze
+ * prev: previous jump point of every jump point on the path.
+ * dest: index of the destination.
+*/
+static void fill_path(struct maze *m, const int *prev, int dest) {
+    int idx = dest;
+
+    while (!maze_at_start(m, maze_row(m, idx), maze_col(m, idx))) {
+        int p = prev[idx];
+        int dir = direction(m, idx, p);
+        int r = maze_row(m, idx);
+        int c = maze_col(m, idx);
+
+        while (maze_index(m, r, c) != p) {
+            maze_set(m, r, c, PATH);
+            r += m_offsets[dir][0];
+            c += m_offsets[dir][1];
+        }
+        idx = p;
+    }
+}
+
+/**
+ * Runs A* over the jump points.
+ * 
+ * j: search state.
+ * h: empty open set.
+ * g: zeroed array for the path length to every jump point plus one.
+ * prev: array for the previous jump point of every jump point.
+ * 
+ * Returns:
+ * the length of the path if a path is found, NOT_FOUND or ERROR otherwise.
+*/
+static int search(struct jps *j, struct iheap *h, int *g, int *prev) {
+    struct maze *m = j->m;
+    int r = 0, c = 0;
+
+    maze_destination(m, &j->dest_r, &j->dest_c);
+    int dest = maze_index(m, j->dest_r, j->dest_c);
+    maze_start(m, &r, &c);
+    int start = maze_index(m, r, c);
+
+    g[start] = 1;
+    prev[start] = -1;
+    iheap_push(h, start, make_key(0, distance(m, start, dest)));
+
+    while (!iheap_empty(h)) {
+        int cur = iheap_pop(h);
+        r = maze_row(m, cur);
+        c = maze_col(m, cur);
+
+        if (j->mt && metrics_expand(j->mt, g[cur] - 1, iheap_size(h) + 1)) return ERROR;
+        if (cur == dest) {
+            double t0 = metrics_now_ms();
+            fill_path(m, prev, dest);
+            if (j->mt) {
+                j->mt->path_ms = metrics_now_ms() - t0;
+            }
+            return g[cur] - 1;
+        }
+        if (!maze_at_start(m, r, c)) {
+            maze_set(m, r, c, VISITED);
+        }
+
+        int in_dir = prev[cur] < 0 ? -1 : direction(m, prev[cur], cur);
+        unsigned dirs = successor_dirs(m, r, c, in_dir);
+
+        for (int dir = 0; dir < N_MOVES; dir++) {
+            if (!((dirs >> dir) & 1)) continue;
+
+            int next = dir == UP || dir == DOWN ? jump_vertical(j, r, c, dir)
+                                                : jump_horizontal(j, r, c, dir);
+            if (next == NO_JUMP || maze_get(m, maze_row(m, next), maze_col(m, next)) == VISITED) {
+                continue;
+            }
+
+            int g_new = g[cur] - 1 + distance(m, cur, next);
+            if (g[next] != 0 && g[next] - 1 <= g_new) continue;
+
+            if (iheap_push(h, next, make_key(g_new, distance(m, next, dest)))) return ERROR;
+            g[next] = g_new + 1;
+            prev[next] = cur;
+        }
+    }
+
+    return NOT_FOUND;
+}
+
+int jps_solve(struct maze *m, struct metrics *mt) {
+    size_t cells = maze_cells(m);
+    struct iheap *h = iheap_init(cells);
+    int *g = calloc(cells, sizeof(int));
+    int *prev = malloc(sizeof(int) * cells);
+    struct jps j = { m, 0, 0, mt };
+    int len = ERROR;
+
+    if (h && g && prev) {
+        len = search(&j, h, g, prev);
+    }
+    if (mt) {
+        mt->bytes = iheap_bytes(h) + 2 * sizeof(int) * cells;
+    }
+
+    iheap_cleanup(h);
+    free(g);
+    free(prev);
+    return len;
+}
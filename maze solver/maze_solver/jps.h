@@ -0,0 +1,17 @@
+#ifndef _JPS_H_
+#define _JPS_H_
+
+#include "maze.h"
+#include "metrics.h"
+#include "solver.h"
+
+/* Solves the maze 'm' with Jump Point Search, an A* search that skips over
+ * the cells of straight runs through open floor and only expands the cells
+ * where a shortest path may have to turn. The cells between the jump points
+ * of the shortest path are filled in with PATH afterwards. If 'mt' is not
+ * NULL the search is measured into it; only jump points count as expanded.
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occured. */
+int jps_solve(struct maze *m, struct metrics *mt);
+
+#endif
@@ -0,0 +1,242 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program keeps a shortest path up to date while walls of the maze are added and removed,
+ * with Lifelong Planning A* (LPA*). Every cell has two distance estimates: g, the distance it
+ * was last expanded with, and rhs, the best distance its neighbors offer now (the cost of moving
+ * into the cell plus the lowest g of a neighbor). A cell is consistent when both are equal. An
+ * edit only changes the rhs of the edited cell and of its neighbors, and the cells that became
+ * inconsistent are queued with the key (min(g, rhs) + h, min(g, rhs)), where h is the Manhattan
+ * distance to the destination.
+ *
+ * A solve expands queued cells in key order until the destination is consistent and no queued
+ * cell could still lead to a cheaper path. A cell whose rhs dropped takes it as its g, like a
+ * cell settled by A*. A cell whose rhs rose forgets its g and is queued again, so the cells that
+ * depended on it are repaired as well. The first solve is a plain A* search, and every later
+ * solve only touches the cells whose distance the edits can change.
+*/
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "iheap.h"
+#include "lpa.h"
+
+#define INF INT_MAX
+
+struct lpa {
+    struct maze *m;
+    int start;
+    int dest;
+    int dest_r;
+    int dest_c;
+    int *g;
+    int *rhs;
+    struct iheap *heap;
+    long expanded;
+    struct metrics *mt;
+};
+
+/* Returns the smaller of 'a' and 'b'. */
+static int min_int(int a, int b) {
+    return a < b ? a : b;
+}
+
+/* Returns the queue key of the cell with maze index 'idx'. The first half of the key orders
+ * by min(g, rhs) + h, the second half breaks ties towards the lower min(g, rhs). */
+static uint64_t key(const struct lpa *s, int idx) {
+    int k = min_int(s->g[idx], s->rhs[idx]);
+    if (k == INF) {
+        return UINT64_MAX;
+    }
+
+    int r = maze_row(s->m, idx), c = maze_col(s->m, idx);
+    uint64_t h = (uint64_t) (abs(r - s->dest_r) + abs(c - s->dest_c));
+    return ((uint64_t) k + h) << 32 | (uint64_t) k;
+}
+
+/**
+ * Recomputes the rhs of the cell (r, c) from its neighbors and queues the cell if it is
+ * inconsistent, or takes it out of the queue if it is not.
+ *
+ * s: session.
+ * r: row of the cell.
+ * c: column of the cell.
+ *
+ * Returns:
+ * 0 if successful, 1 if the queue could not grow.
+*/
+static int update_cell(struct lpa *s, int r, int c) {
+    const struct maze *m = s->m;
+    int idx = maze_index(m, r, c);
+
+    if (idx != s->start) {
+        int best = INF;
+        if (maze_walkable(m, r, c)) {
+            for (int dir = 0; dir < N_MOVES; dir++) {
+                int r_new = r + m_offsets[dir][0];
+                int c_new = c + m_offsets[dir][1];
+                if (!maze_walkable(m, r_new, c_new)) continue;
+
+                int g = s->g[maze_index(m, r_new, c_new)];
+                if (g != INF) {
+                    best = min_int(best, g + maze_cost(m, r, c));
+                }
+            }
+        }
+        s->rhs[idx] = best;
+    }
+
+    iheap_remove(s->heap, idx);
+    if (s->g[idx] != s->rhs[idx]) {
+        return iheap_push(s->heap, idx, key(s, idx));
+    }
+    return 0;
+}
+
+/**
+ * Updates the neighbors of the cell (r, c) after its g changed.
+ *
+ * s: session.
+ * r: row of the cell.
+ * c: column of the cell.
+ *
+ * Returns:
+ * 0 if successful, 1 if the queue could not grow.
+*/
+static int update_neighbors(struct lpa *s, int r, int c) {
+    for (int dir = 0; dir < N_MOVES; dir++) {
+        int r_new = r + m_offsets[dir][0];
+        int c_new = c + m_offsets[dir][1];
+        if (maze_valid_move(s->m, r_new, c_new) && update_cell(s, r_new, c_new)) return 1;
+    }
+    return 0;
+}
+
+struct lpa *lpa_init(struct maze *m) {
+    size_t cells = maze_cells(m);
+    int r = 0, c = 0;
+
+    struct lpa *s = calloc(1, sizeof(struct lpa));
+    if (!s) {
+        return NULL;
+    }
+    s->m = m;
+    s->g = malloc(sizeof(int) * cells);
+    s->rhs = malloc(sizeof(int) * cells);
+    s->heap = iheap_init(cells);
+    if (!s->g || !s->rhs || !s->heap) {
+        lpa_cleanup(s);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < cells; i++) {
+        s->g[i] = INF;
+        s->rhs[i] = INF;
+    }
+    maze_destination(m, &s->dest_r, &s->dest_c);
+    s->dest = maze_index(m, s->dest_r, s->dest_c);
+    maze_start(m, &r, &c);
+    s->start = maze_index(m, r, c);
+
+    /* Only the start is inconsistent before the first solve. */
+    s->rhs[s->start] = 0;
+    if (iheap_push(s->heap, s->start, key(s, s->start))) {
+        lpa_cleanup(s);
+        return NULL;
+    }
+    return s;
+}
+
+void lpa_cleanup(struct lpa *s) {
+    if (s == NULL) return;
+    free(s->g);
+    free(s->rhs);
+    iheap_cleanup(s->heap);
+    free(s);
+}
+
+int lpa_set_wall(struct lpa *s, int r, int c, bool wall) {
+    struct maze *m = s->m;
+
+    if (!maze_valid_move(m, r, c)) return 1;
+    int idx = maze_index(m, r, c);
+    if (idx == s->start || idx == s->dest) return 1;
+    if (maze_is_wall(m, r, c) == wall) return 0;
+
+    maze_set(m, r, c, wall ? WALL : FLOOR);
+
+    /* The moves into the cell changed, and so did the moves out of it into its neighbors. */
+    return update_cell(s, r, c) || update_neighbors(s, r, c);
+}
+
+int lpa_solve(struct lpa *s) {
+    const struct maze *m = s->m;
+
+    s->expanded = 0;
+    while (!iheap_empty(s->heap)
+           && (iheap_top_key(s->heap) < key(s, s->dest) || s->g[s->dest] != s->rhs[s->dest])) {
+        int idx = iheap_pop(s->heap);
+        int r = maze_row(m, idx), c = maze_col(m, idx);
+        s->expanded++;
+        if (s->mt && metrics_expand(s->mt, min_int(s->g[idx], s->rhs[idx]), iheap_size(s->heap) + 1)) {
+            return ERROR;
+        }
+
+        if (s->g[idx] > s->rhs[idx]) {
+            s->g[idx] = s->rhs[idx];
+        } else {
+            s->g[idx] = INF;
+            if (update_cell(s, r, c)) return ERROR;
+        }
+        if (update_neighbors(s, r, c)) return ERROR;
+    }
+
+    if (s->mt) {
+        s->mt->bytes = iheap_bytes(s->heap) + 2 * sizeof(int) * maze_cells(m);
+    }
+    return s->g[s->dest] == INF ? NOT_FOUND : s->g[s->dest];
+}
+
+void lpa_measure(struct lpa *s, struct metrics *mt) {
+    s->mt = mt;
+}
+
+long lpa_expanded(const struct lpa *s) {
+    return s->expanded;
+}
+
+int lpa_predecessor(const struct lpa *s, int idx) {
+    const struct maze *m = s->m;
+    int r = maze_row(m, idx), c = maze_col(m, idx);
+    int best = -1;
+
+    if (idx == s->start || s->g[idx] == INF) {
+        return -1;
+    }
+
+    /* Every move into the cell costs the same, so the neighbor with the lowest g comes before it. */
+    for (int dir = 0; dir < N_MOVES; dir++) {
+        int r_new = r + m_offsets[dir][0];
+        int c_new = c + m_offsets[dir][1];
+        if (!maze_walkable(m, r_new, c_new)) continue;
+
+        int prev = maze_index(m, r_new, c_new);
+        if (s->g[prev] != INF && (best == -1 || s->g[prev] < s->g[best])) {
+            best = prev;
+        }
+    }
+    return best;
+}
+
+void lpa_paint(const struct lpa *s, struct maze *m) {
+    if (s->g[s->dest] == INF) return;
+
+    for (int idx = s->dest; idx != s->start && idx != -1; idx = lpa_predecessor(s, idx)) {
+        maze_set(m, maze_row(m, idx), maze_col(m, idx), PATH);
+    }
+}
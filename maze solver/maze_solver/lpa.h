@@ -0,0 +1,54 @@
+#ifndef _LPA_H_
+#define _LPA_H_
+
+#include <stdbool.h>
+
+#include "maze.h"
+#include "metrics.h"
+#include "solver.h"
+
+/* Handle to an incremental search from the start to the destination of a maze */
+struct lpa;
+
+/* Starts a session on maze 'm' that keeps its search state between solves.
+ * The walls of 'm' may only be changed with lpa_set_wall() while the session
+ * is open; the maze is not marked by the search.
+ * Returns a pointer to the session or NULL if an error occured. */
+struct lpa *lpa_init(struct maze *m);
+
+/* Frees all memory associated with the session. */
+void lpa_cleanup(struct lpa *s);
+
+/* Makes (r, c) a WALL if 'wall' is true and a FLOOR otherwise, and marks the
+ * cells whose distance may change by it for the next lpa_solve(). Setting a
+ * cell to what it already is does nothing.
+ * Returns 0 if successful, 1 if (r, c) is the start, the destination or on
+ * the border of the maze, or if an error occured. */
+int lpa_set_wall(struct lpa *s, int r, int c, bool wall);
+
+/* Finds the cost of the cheapest path from the start to the destination with
+ * Lifelong Planning A* (LPA*). The first solve is a plain A* search; after
+ * that only the cells affected by the edits since the last solve are
+ * expanded again.
+ * Returns the cost of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occured. */
+int lpa_solve(struct lpa *s);
+
+/* Returns the number of cells expanded by the last lpa_solve(). */
+long lpa_expanded(const struct lpa *s);
+
+/* Measures the following solves of 's' into 'mt', or stops measuring if 'mt'
+ * is NULL. A cell counts as expanded at its cost from the start when it is
+ * taken from the queue. */
+void lpa_measure(struct lpa *s, struct metrics *mt);
+
+/* Returns the maze index of the cell before cell 'idx' on a cheapest path
+ * from the start, as found by the last lpa_solve(), or -1 if 'idx' is the
+ * start or cannot be reached. */
+int lpa_predecessor(const struct lpa *s, int idx);
+
+/* Marks every cell of the path found by the last successful lpa_solve() with
+ * PATH in 'm', except for the start cell. */
+void lpa_paint(const struct lpa *s, struct maze *m);
+
+#endif
@@ -1,26 +1,92 @@
-/* Do not edit this file. */
-
-// Needed for getline()
+// Needed for fileno() and mmap()
 #define _POSIX_C_SOURCE 200809L
 
 #include <assert.h>
+#include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "maze.h"
 
 #define START 'S'
 #define FINISH 'D'
 
+/* Digits in a maze file from MIN_COST_DIGIT up are floor cells with a cost. */
+#define MIN_COST_DIGIT '2'
+
+#define WORD_BITS 64
+
+/* The grid is stored as three bit planes. Every row starts at a new 64-bit
+ * word, so row 'r' of a plane is the 'stride' words starting at r * stride.
+ * A set bit in 'walls' is a WALL. For open cells the 'visited' and 'path'
+ * planes together encode the character returned by maze_get():
+ *
+ *   visited path
+ *      0     0     FLOOR
+ *      1     0     VISITED
+ *      0     1     PATH
+ *      1     1     TO_VISIT
+ *
+ * Cells that cost more than one step to enter have their cost in 'cost',
+ * indexed by maze_index(). The array only exists once such a cell is read;
+ * until then, and for a 0 in it, every cell costs 1.
+ */
 struct maze {
     int n;
     int start_index;
     int finish_index;
-    char *data;
+    int stride;
+    int tiles;
+    uint64_t *walls;
+    uint64_t *visited;
+    uint64_t *path;
+    unsigned char *cost;
+    int max_cost;
+    void *map;
+    size_t map_size;
+};
+
+/* Cell indices are row-major by default: row 'r' starts at index r * n. When
+ * compiled with MAZE_TILED the index space is split into tiles of TILE by TILE
+ * cells instead, stored row by row, and the cells inside a tile row by row as
+ * well. The up and down neighbors of a cell are then usually in the same tile,
+ * TILE entries away in a side array instead of 'n'. The index space is
+ * rounded up to whole tiles, so it can be larger than n * n. */
+#define TILE_BITS 3
+#define TILE (1 << TILE_BITS)
+
+/* A binary maze file is this header followed by the wall plane exactly as it
+ * is stored in memory: 'stride' 64-bit words per row, in the byte order of the
+ * machine that wrote it. The header is 32 bytes, so the plane can be used in
+ * place from a mapping of the file. The start and destination are stored as
+ * 64-bit row-major indices, whatever layout maze_index() uses, so streamed
+ * mazes larger than 65535 cells a side keep their endpoints. Version 1 files
+ * had 32-bit indices and are not accepted. */
+#define BINARY_MAGIC "MAZB"
+#define BINARY_ORDER 0x01020304u
+#define BINARY_VERSION 2
+
+struct binary_header {
+    char magic[4];
+    uint32_t order;
+    uint32_t n;
+    uint32_t version;
+    uint64_t start_index;
+    uint64_t finish_index;
 };
 
+/* Largest size of a maze in memory. maze_index() returns an int, and with the
+ * tiled layout the index space is rounded up to whole tiles, so this is the
+ * largest multiple of TILE whose square fits in an int. Row-major alone would
+ * allow 46340. */
+#define MAX_SIZE 46336
+
 /* Move offsets: (row, column) We can only move in four directions.
  *
  *           (-1,0)
@@ -29,6 +95,14 @@ struct maze {
  */
 int m_offsets[N_MOVES][2] = { { -1, 0 }, { 0, 1 }, { 1, 0 }, { 0, -1 } };
 
+/* Sets the size of maze 'm' to 'n' and derives the layout of its planes and
+ * of the cell indices from it. */
+static void set_layout(struct maze *m, int n) {
+    m->n = n;
+    m->stride = (n + WORD_BITS - 1) / WORD_BITS;
+    m->tiles = (n + TILE - 1) / TILE;
+}
+
 /* Creates a square maze structure of 'n' rows by 'n' columns filled with
  * walls. maze_init() is not part of the maze interface, it is a helper
  * function for maze_read().
@@ -36,18 +110,32 @@ int m_offsets[N_MOVES][2] = { { -1, 0 }, { 0, 1 }, { 1, 0 }, { 0, -1 } };
 struct maze *maze_init(int n) {
     if (n <= 0) {
         return NULL;
+    } else if (n > MAX_SIZE) {
+        fprintf(stderr, "Mazes in memory can be at most %d cells a side\n", MAX_SIZE);
+        return NULL;
     }
     struct maze *m = malloc(sizeof(struct maze));
     if (!m) {
         return NULL;
     }
-    m->n = n;
-    m->data = calloc(1, (size_t)(m->n * m->n * (int) sizeof(char)));
-    if (!m->data) {
+    set_layout(m, n);
+    m->cost = NULL;
+    m->max_cost = 1;
+    m->map = NULL;
+    m->map_size = 0;
+
+    size_t words = (size_t) m->stride * (size_t) n;
+    m->walls = malloc(3 * words * sizeof(uint64_t));
+    if (!m->walls) {
         free(m);
         return NULL;
     }
-    memset(m->data, WALL, (size_t)(m->n * m->n));
+    m->visited = m->walls + words;
+    m->path = m->visited + words;
+
+    /* Padding bits behind the last column stay walls as well. */
+    memset(m->walls, 0xff, words * sizeof(uint64_t));
+    memset(m->visited, 0, 2 * words * sizeof(uint64_t));
 
     // And finally set the default start and finish locations.
     m->start_index = maze_index(m, 1, 1); // upper left
@@ -57,18 +145,130 @@ struct maze *maze_init(int n) {
 }
 
 void maze_cleanup(struct maze *m) {
-    free(m->data);
+    if (m->map) {
+        /* The wall plane lives in the mapping, the other planes on their own. */
+        munmap(m->map, m->map_size);
+        free(m->visited);
+    } else {
+        free(m->walls);
+    }
+    free(m->cost);
     free(m);
 }
 
+/* Returns the word offset of column 'c' in row 'r' of a bit plane. */
+static size_t word_of(const struct maze *m, int r, int c) {
+    return (size_t) r * (size_t) m->stride + (size_t) (c / WORD_BITS);
+}
+
+/* Returns the mask of column 'c' within its word. */
+static uint64_t bit_of(int c) {
+    return (uint64_t) 1 << (c % WORD_BITS);
+}
+
 char maze_get(const struct maze *m, int r, int c) {
     assert(r >= 0 && r < m->n && c >= 0 && c < m->n);
-    return m->data[r * m->n + c];
+    size_t w = word_of(m, r, c);
+    uint64_t b = bit_of(c);
+
+    if (m->walls[w] & b) {
+        return WALL;
+    }
+
+    bool visited = m->visited[w] & b;
+    bool path = m->path[w] & b;
+    if (visited && path) {
+        return TO_VISIT;
+    } else if (visited) {
+        return VISITED;
+    } else if (path) {
+        return PATH;
+    }
+    return FLOOR;
 }
 
 void maze_set(struct maze *m, int r, int c, char value) {
     assert(r >= 0 && r < m->n && c >= 0 && c < m->n);
-    m->data[r * m->n + c] = value;
+    size_t w = word_of(m, r, c);
+    uint64_t b = bit_of(c);
+
+    m->walls[w] &= ~b;
+    m->visited[w] &= ~b;
+    m->path[w] &= ~b;
+
+    if (value == WALL) {
+        m->walls[w] |= b;
+    } else if (value == VISITED) {
+        m->visited[w] |= b;
+    } else if (value == PATH) {
+        m->path[w] |= b;
+    } else if (value == TO_VISIT) {
+        m->visited[w] |= b;
+        m->path[w] |= b;
+    }
+}
+
+bool maze_is_wall(const struct maze *m, int r, int c) {
+    assert(r >= 0 && r < m->n && c >= 0 && c < m->n);
+    return m->walls[word_of(m, r, c)] & bit_of(c);
+}
+
+unsigned maze_open_neighbors(const struct maze *m, int r, int c) {
+    assert(r >= 0 && r < m->n && c >= 0 && c < m->n);
+    if (r == 0 || r == m->n - 1 || c == 0 || c == m->n - 1) {
+        /* Border cell: moves off the grid count as walls. */
+        unsigned open = 0;
+        for (int i = 0; i < N_MOVES; i++) {
+            int r_new = r + m_offsets[i][0];
+            int c_new = c + m_offsets[i][1];
+            if (r_new >= 0 && r_new < m->n && c_new >= 0 && c_new < m->n
+                && !maze_is_wall(m, r_new, c_new)) {
+                open |= 1u << i;
+            }
+        }
+        return open;
+    }
+
+    const uint64_t *row = m->walls + word_of(m, r, c);
+    const uint64_t *up = row - m->stride;
+    const uint64_t *down = row + m->stride;
+    int bit = c % WORD_BITS;
+
+    /* Gather the wall bits of (left, self, right) into bits 0, 1 and 2. */
+    uint64_t around;
+    if (bit > 0) {
+        around = row[0] >> (bit - 1);
+    } else {
+        around = row[0] << 1 | row[-1] >> (WORD_BITS - 1);
+    }
+    if (bit == WORD_BITS - 1) {
+        around |= (row[1] & 1) << 2;
+    }
+
+    uint64_t walls = ((up[0] >> bit) & 1)
+                   | ((around >> 2) & 1) << 1
+                   | ((down[0] >> bit) & 1) << 2
+                   | (around & 1) << 3;
+    return (unsigned) (~walls & 0xf);
+}
+
+int maze_stride(const struct maze *m) {
+    return m->stride;
+}
+
+const uint64_t *maze_walls(const struct maze *m) {
+    return m->walls;
+}
+
+uint64_t maze_walls_hash(const struct maze *m) {
+    size_t words = (size_t) m->stride * (size_t) m->n;
+    uint64_t h = 0xcbf29ce484222325ULL;
+
+    /* FNV-1a over whole words of the wall plane. */
+    for (size_t i = 0; i < words; i++) {
+        h = (h ^ m->walls[i]) * 0x100000001b3ULL;
+    }
+    return h ^ (uint64_t) m->n;
 }
 
 void maze_print(const struct maze *m, bool blocks) {
@@ -80,6 +280,8 @@ void maze_print(const struct maze *m, bool blocks) {
                 putchar(START);
             } else if (maze_at_destination(m, r, c)) {
                 putchar(FINISH);
+            } else if (maze_get(m, r, c) == FLOOR && maze_cost(m, r, c) > 1) {
+                putchar('0' + maze_cost(m, r, c));
             } else {
                 putchar(maze_get(m, r, c));
             }
@@ -139,63 +341,645 @@ int maze_output_ppm(const struct maze *m, const char *filename) {
     return 0;
 }
 
-/* Detect and set start and finish locations in maze 'm'. */
-static void check_for_start_and_dest(struct maze *m, int r, int c, char val) {
-    if (val == START) {
+/* Returns the column of the last 'marker' in the 'n' characters of 'line',
+ * or -1 if there is none. */
+static int last_marker(const char *line, int n, char marker) {
+    const char *p = line;
+    const char *end = line + n;
+    int c = -1;
+
+    while ((p = memchr(p, marker, (size_t) (end - p))) != NULL) {
+        c = (int) (p - line);
+        p++;
+    }
+    return c;
+}
+
+/* Detect and set start and finish locations in row 'r' of maze 'm'. The
+ * last marker in reading order wins, as if every cell was checked. */
+static void check_for_start_and_dest(struct maze *m, int r, const char *line) {
+    int c = last_marker(line, m->n, START);
+    if (c >= 0) {
         m->start_index = maze_index(m, r, c);
-    } else if (val == FINISH) {
+    }
+    c = last_marker(line, m->n, FINISH);
+    if (c >= 0) {
         m->finish_index = maze_index(m, r, c);
     }
 }
 
-/* Set 'val' character in 'm' at position 'r', 'c'. */
-static void set_value(struct maze *m, int r, int c, char val) {
-    if (val == WALL) {
-        maze_set(m, r, c, WALL);
-    } else {
-        /* Should overwrite start and finish markers with FLOOR. */
-        maze_set(m, r, c, FLOOR);
+/* Returns an 8-bit mask of the bytes in 'chunk' that equal WALL, the first
+ * byte in bit 0. The bytes are compared eight at a time in one 64-bit word:
+ * a byte of 'x' is zero only for a WALL, and only then does its top bit stay
+ * clear after adding 0x7f to its lower seven bits. The eight top bits are
+ * then gathered into one byte with a multiplication. */
+static unsigned wall_bits8(const char *chunk) {
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t low7 = 0x7f7f7f7f7f7f7f7fULL;
+    uint64_t v;
+
+    memcpy(&v, chunk, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    uint64_t x = v ^ (ones * (unsigned char) WALL);
+    uint64_t eq = ~(((x & low7) + low7) | x) & (ones << 7);
+    return (unsigned) (((eq >> 7) * 0x0102040810204080ULL) >> 56);
+}
+
+/* Fills the 'stride' words of 'row' with the wall bits of the 'n' characters
+ * of 'line'. Every character that is not a WALL is stored as a FLOOR, which
+ * also overwrites the start and finish markers. Whole words are written at
+ * once, so bits behind the last column are set again as padding. */
+static void parse_row(uint64_t *row, int n, int stride, const char *line) {
+    for (int w = 0; w < stride; w++) {
+        int c0 = w * WORD_BITS;
+        int count = n - c0 < WORD_BITS ? n - c0 : WORD_BITS;
+        uint64_t bits = 0;
+        int c = 0;
+
+        for (; c + 8 <= count; c += 8) {
+            bits |= (uint64_t) wall_bits8(line + c0 + c) << c;
+        }
+        for (; c < count; c++) {
+            bits |= (uint64_t) (line[c0 + c] == WALL) << c;
+        }
+        if (count < WORD_BITS) {
+            bits |= ~(uint64_t) 0 << count;
+        }
+        row[w] = bits;
     }
 }
 
-struct maze *maze_read(void) {
-    char *buf = NULL;
-    size_t bufsize = 0;
+/* Fills row 'r' of the wall plane of maze 'm' from 'line'. */
+static void set_row(struct maze *m, int r, const char *line) {
+    parse_row(m->walls + word_of(m, r, 0), m->n, m->stride, line);
+}
+
+/* Returns nonzero if any of the 8 bytes in 'chunk' is a cost digit from
+ * MIN_COST_DIGIT to '9'. Like wall_bits8() all eight bytes are tested at
+ * once: subtracting from 127 + ('9' + 1) and adding 127 - (MIN_COST_DIGIT - 1)
+ * to the lower seven bits of a byte only leaves both top bits set inside the
+ * range, and bytes with their own top bit set are masked out. */
+static uint64_t cost_bytes8(const char *chunk) {
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t low7 = ones * 0x7f;
+    uint64_t v;
+
+    memcpy(&v, chunk, sizeof(v));
+    uint64_t x = v & low7;
+    uint64_t below_top = ones * (127 + '9' + 1) - x;
+    uint64_t above_bottom = x + ones * (127 - (MIN_COST_DIGIT - 1));
+    return below_top & ~v & above_bottom & (ones << 7);
+}
+
+/* Stores the cost of a digit 'ch' for the cell (r, c) of maze 'm', creating
+ * the cost array for the first one. A path visits every cell at most once, so
+ * its cost stays below the number of cells times the highest cost; the maze
+ * is refused when that product does not fit in an int, the type the solvers
+ * return the cost of a path in.
+ * Returns 0 if successful, 1 if the maze is too large for its costs or
+ * memory could not be allocated. */
+static int set_cost(struct maze *m, int r, int c, char ch) {
+    int cost = ch - '0';
+    if (cost > m->max_cost && (size_t) m->n * (size_t) m->n * (size_t) cost > INT_MAX) {
+        fprintf(stderr, "Mazes with cells of cost %d can be at most %zu cells in total\n", cost,
+                (size_t) INT_MAX / (size_t) cost);
+        return 1;
+    }
+    if (!m->cost) {
+        m->cost = calloc(maze_cells(m), sizeof(unsigned char));
+        if (!m->cost) {
+            return 1;
+        }
+    }
+    m->cost[maze_index(m, r, c)] = (unsigned char) cost;
+    if (cost > m->max_cost) {
+        m->max_cost = cost;
+    }
+    return 0;
+}
+
+/* Stores the costs of the digits in row 'r' of maze 'm' with the 'n'
+ * characters of 'line'. Lines without digits are skipped eight characters at
+ * a time, so plain mazes pay almost nothing for this.
+ * Returns 0 if successful, 1 if memory could not be allocated. */
+static int set_costs(struct maze *m, int r, const char *line) {
+    int c = 0;
+
+    for (; c + 8 <= m->n; c += 8) {
+        if (!cost_bytes8(line + c)) continue;
+        for (int i = c; i < c + 8; i++) {
+            if (line[i] >= MIN_COST_DIGIT && line[i] <= '9' && set_cost(m, r, i, line[i])) return 1;
+        }
+    }
+    for (; c < m->n; c++) {
+        if (line[c] >= MIN_COST_DIGIT && line[c] <= '9' && set_cost(m, r, c, line[c])) return 1;
+    }
+    return 0;
+}
+
+/* Returns the length of the line at 'p' including its newline, like
+ * getline() would, with 'size' bytes left in the buffer. */
+static size_t line_length(const char *p, size_t size) {
+    const char *nl = memchr(p, '\n', size);
+    return nl ? (size_t) (nl - p) + 1 : size;
+}
+
+/* Parses a maze from the 'size' bytes of 'data'. The first line sets the
+ * number of columns. Reading stops at the first line of a different length,
+ * and the maze is only valid if exactly that many rows were read.
+ * Returns a pointer to the maze or NULL if an error occured. */
+static struct maze *maze_parse(const char *data, size_t size) {
+    if (size == 0 || size - 1 > INT_MAX) {
+        return NULL;
+    }
 
-    /* Read one line to get number of columns so we can allocate the maze. */
-    int ncols = (int) getline(&buf, &bufsize, stdin) - 1;
+    size_t len = line_length(data, size);
+    int ncols = (int) len - 1;
     struct maze *m = maze_init(ncols);
     if (!m) {
-        free(buf);
         return NULL;
     }
 
+    size_t pos = 0;
     int row = 0;
     do {
         if (row == ncols) { /* Error: more rows than columns */
             maze_cleanup(m);
-            free(buf);
             return NULL;
         }
 
-        int column = 0;
-        while (buf[column] != '\n') {
-            check_for_start_and_dest(m, row, column, buf[column]);
-            set_value(m, row, column, buf[column]);
-            column++;
+        check_for_start_and_dest(m, row, data + pos);
+        set_row(m, row, data + pos);
+        if (set_costs(m, row, data + pos)) {
+            maze_cleanup(m);
+            return NULL;
         }
         row++;
-    } while (getline(&buf, &bufsize, stdin) == ncols + 1); // ncols + \n
+        pos += len;
+        len = pos < size ? line_length(data + pos, size - pos) : 0;
+    } while (len == (size_t) ncols + 1); // ncols + \n
 
     if (row < ncols) { /* Error: more columns than rows */
         maze_cleanup(m);
         m = NULL;
     }
+    return m;
+}
+
+/* Reads the rest of 'fp' into a new buffer for streams that cannot be
+ * mapped, such as pipes. The size is stored in 'size'.
+ * Returns the buffer or NULL if an error occured. */
+static char *read_stream(FILE *fp, size_t *size) {
+    size_t cap = 4096;
+    char *buf = malloc(cap);
+    *size = 0;
+
+    while (buf) {
+        *size += fread(buf + *size, 1, cap - *size, fp);
+        if (*size < cap) {
+            if (ferror(fp)) break;
+            return buf;
+        }
+        char *tmp = realloc(buf, cap * 2);
+        if (!tmp) break;
+        buf = tmp;
+        cap *= 2;
+    }
+    free(buf);
+    return NULL;
+}
+
+/* Returns the header of a binary maze in the 'size' bytes of 'data' if it
+ * is valid and matches the size of the data, NULL otherwise. */
+static const struct binary_header *binary_header(const void *data, size_t size) {
+    const struct binary_header *h = data;
+
+    if (size < sizeof(*h) || memcmp(h->magic, BINARY_MAGIC, 4) != 0 || h->order != BINARY_ORDER
+        || h->version != BINARY_VERSION || h->n == 0 || h->n > INT_MAX) {
+        return NULL;
+    }
+    uint64_t n = h->n;
+    uint64_t stride = (n + WORD_BITS - 1) / WORD_BITS;
+    if (size - sizeof(*h) != stride * n * sizeof(uint64_t) || h->start_index >= n * n
+        || h->finish_index >= n * n) {
+        return NULL;
+    }
+    return h;
+}
+
+/* Sets the start and destination of maze 'm' from the row-major indices in
+ * binary header 'h'. */
+static void set_endpoints(struct maze *m, const struct binary_header *h) {
+    uint64_t n = (uint64_t) m->n;
+    m->start_index = maze_index(m, (int) (h->start_index / n), (int) (h->start_index % n));
+    m->finish_index = maze_index(m, (int) (h->finish_index / n), (int) (h->finish_index % n));
+}
+
+/* Sets the padding bits behind the last column of every row of the wall
+ * plane. Rows that are already correct are not written to, so the pages of a
+ * mapped plane are only copied when the file is damaged. */
+static void fix_padding(struct maze *m) {
+    int tail = m->n % WORD_BITS;
+    if (tail == 0) {
+        return;
+    }
+    uint64_t pad = ~(uint64_t) 0 << tail;
+    for (int r = 0; r < m->n; r++) {
+        uint64_t *last = m->walls + word_of(m, r, m->n - 1);
+        if ((*last & pad) != pad) {
+            *last |= pad;
+        }
+    }
+}
+
+/* Creates a maze that uses the wall plane of the binary maze mapped at 'map'
+ * in place. The maze takes over the mapping, which must be private and
+ * writable so solvers can still change walls without touching the file.
+ * Returns a pointer to the maze or NULL if an error occured. */
+static struct maze *maze_from_mapping(void *map, size_t size) {
+    const struct binary_header *h = binary_header(map, size);
+    if (!h) {
+        return NULL;
+    } else if (h->n > MAX_SIZE) {
+        fprintf(stderr, "Mazes in memory can be at most %d cells a side\n", MAX_SIZE);
+        return NULL;
+    }
+
+    struct maze *m = malloc(sizeof(struct maze));
+    if (!m) {
+        return NULL;
+    }
+    set_layout(m, (int) h->n);
+    set_endpoints(m, h);
+    m->cost = NULL;
+    m->max_cost = 1;
+
+    size_t words = (size_t) m->stride * (size_t) m->n;
+    m->visited = calloc(2 * words, sizeof(uint64_t));
+    if (!m->visited) {
+        free(m);
+        return NULL;
+    }
+    m->path = m->visited + words;
+    m->walls = (uint64_t *) ((char *) map + sizeof(*h));
+    m->map = map;
+    m->map_size = size;
+
+    fix_padding(m);
+    return m;
+}
+
+/* Creates a maze from a binary maze in the 'size' bytes of 'data' by copying
+ * its wall plane.
+ * Returns a pointer to the maze or NULL if an error occured. */
+static struct maze *maze_from_binary(const void *data, size_t size) {
+    const struct binary_header *h = binary_header(data, size);
+    if (!h) {
+        return NULL;
+    }
+
+    struct maze *m = maze_init((int) h->n);
+    if (!m) {
+        return NULL;
+    }
+    set_endpoints(m, h);
+    memcpy(m->walls, (const char *) data + sizeof(*h), size - sizeof(*h));
+
+    fix_padding(m);
+    return m;
+}
+
+/* Returns true if the 'size' bytes of 'data' start like a binary maze. */
+static bool is_binary(const void *data, size_t size) {
+    return size >= 4 && memcmp(data, BINARY_MAGIC, 4) == 0;
+}
+
+/* Maps the regular file behind 'fp' into memory. The mapping is private and
+ * writable, so changes never reach the file.
+ * Returns the mapping and stores its size in 'size', or NULL if 'fp' cannot
+ * be mapped. */
+static void *map_stream(FILE *fp, size_t *size) {
+    int fd = fileno(fp);
+    struct stat st;
+
+    if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0
+        || lseek(fd, 0, SEEK_CUR) != 0) {
+        return NULL;
+    }
+    *size = (size_t) st.st_size;
+    void *data = mmap(NULL, *size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    return data == MAP_FAILED ? NULL : data;
+}
+
+/* Parses the maze in the open file 'fp', which may be a text or a binary
+ * maze. A regular file is mapped into memory and parsed in place, anything
+ * else is read into a buffer first. The wall plane of a mapped binary maze is
+ * used directly.
+ * Returns a pointer to the maze or NULL if an error occured. */
+static struct maze *maze_read_stream(FILE *fp) {
+    size_t size;
+    struct maze *m;
+    void *data = map_stream(fp, &size);
+
+    if (data) {
+        if (is_binary(data, size)) {
+            m = maze_from_mapping(data, size);
+            if (!m) {
+                munmap(data, size);
+            }
+            return m;
+        }
+        posix_madvise(data, size, POSIX_MADV_SEQUENTIAL);
+        m = maze_parse(data, size);
+        munmap(data, size);
+        return m;
+    }
 
+    char *buf = read_stream(fp, &size);
+    if (!buf) {
+        return NULL;
+    }
+    m = is_binary(buf, size) ? maze_from_binary(buf, size) : maze_parse(buf, size);
     free(buf);
     return m;
 }
 
+struct maze *maze_read(void) {
+    return maze_read_stream(stdin);
+}
+
+struct maze *maze_read_file(const char *filename) {
+    FILE *fp = fopen(filename, "r");
+    if (!fp) {
+        return NULL;
+    }
+    struct maze *m = maze_read_stream(fp);
+    fclose(fp);
+    return m;
+}
+
+struct maze *maze_read_binary(const char *filename) {
+    FILE *fp = fopen(filename, "r");
+    if (!fp) {
+        return NULL;
+    }
+
+    size_t size;
+    struct maze *m;
+    void *data = map_stream(fp, &size);
+    if (data) {
+        m = maze_from_mapping(data, size);
+        if (!m) {
+            munmap(data, size);
+        }
+    } else {
+        char *buf = read_stream(fp, &size);
+        m = buf ? maze_from_binary(buf, size) : NULL;
+        free(buf);
+    }
+
+    fclose(fp);
+    return m;
+}
+
+int maze_write_binary(const struct maze *m, const char *filename) {
+    int r = 0, c = 0, dest_r = 0, dest_c = 0;
+    if (m->cost) {
+        fprintf(stderr, "Binary mazes cannot hold cell costs\n");
+        return 1;
+    }
+    maze_start(m, &r, &c);
+    maze_destination(m, &dest_r, &dest_c);
+
+    uint64_t n = (uint64_t) m->n;
+    struct binary_header h = { BINARY_MAGIC, BINARY_ORDER, (uint32_t) m->n, BINARY_VERSION,
+                               (uint64_t) r * n + (uint64_t) c, (uint64_t) dest_r * n + (uint64_t) dest_c };
+    size_t words = (size_t) m->stride * (size_t) m->n;
+
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) {
+        fprintf(stderr, "Cannot open file %s\n", filename);
+        return 1;
+    }
+    bool ok = fwrite(&h, sizeof(h), 1, fp) == 1 && fwrite(m->walls, sizeof(uint64_t), words, fp) == words;
+    if (fclose(fp) != 0 || !ok) {
+        fprintf(stderr, "Cannot write file %s\n", filename);
+        return 1;
+    }
+    return 0;
+}
+
+/* A maze stream only keeps the open file and the size, start and destination
+ * of the maze. Every row of a text maze is 'n' characters and a newline and
+ * every row of a binary maze 'stride' words, so each row starts at a fixed
+ * offset and a band of rows is read with a single fread(). The start and
+ * destination are row-major indices. */
+struct maze_stream {
+    FILE *fp;
+    int n;
+    int stride;
+    bool binary;
+    int next_row;
+    size_t start_index;
+    size_t finish_index;
+    char *text;
+    size_t text_size;
+};
+
+/* Number of bytes of walls maze_stream_write_binary() copies at once. */
+#define STREAM_BAND (1 << 20)
+
+/* Returns the offset of row 'r' in the file of stream 's'. */
+static off_t stream_offset(const struct maze_stream *s, int r) {
+    if (s->binary) {
+        return (off_t) sizeof(struct binary_header) + (off_t) r * s->stride * (off_t) sizeof(uint64_t);
+    }
+    return (off_t) r * (s->n + 1);
+}
+
+/* Sets the size of stream 's' from the first line of its text maze and
+ * scans all rows once for the start and destination markers, which also
+ * checks that there are 'n' rows of 'n' characters.
+ * Returns 0 if successful, 1 if the file is not a valid maze. */
+static int scan_text(struct maze_stream *s) {
+    char *line = NULL;
+    size_t cap = 0;
+    ssize_t len = getline(&line, &cap, s->fp);
+
+    if (len < 2 || line[len - 1] != '\n' || len - 1 > INT_MAX) {
+        free(line);
+        return 1;
+    }
+    s->n = (int) len - 1;
+    s->start_index = (size_t) s->n + 1;
+    s->finish_index = (size_t) (s->n - 2) * (size_t) s->n + (size_t) s->n - 2;
+
+    int r = 0;
+    do {
+        int c = last_marker(line, s->n, START);
+        if (c >= 0) {
+            s->start_index = (size_t) r * (size_t) s->n + (size_t) c;
+        }
+        c = last_marker(line, s->n, FINISH);
+        if (c >= 0) {
+            s->finish_index = (size_t) r * (size_t) s->n + (size_t) c;
+        }
+        r++;
+    } while (r < s->n && fread(line, 1, (size_t) s->n + 1, s->fp) == (size_t) s->n + 1
+             && line[s->n] == '\n');
+
+    free(line);
+    return r < s->n || fseeko(s->fp, 0, SEEK_SET) != 0;
+}
+
+/* Reads the binary header of stream 's', whose file is 'size' bytes.
+ * Returns 0 if successful, 1 if the file is not a valid binary maze. */
+static int read_header(struct maze_stream *s, size_t size) {
+    struct binary_header h;
+
+    if (fread(&h, sizeof(h), 1, s->fp) != 1 || !binary_header(&h, size)) {
+        return 1;
+    }
+    s->n = (int) h.n;
+    s->start_index = h.start_index;
+    s->finish_index = h.finish_index;
+    return 0;
+}
+
+struct maze_stream *maze_stream_open(const char *filename) {
+    char magic[4];
+    struct stat st;
+
+    struct maze_stream *s = calloc(1, sizeof(struct maze_stream));
+    if (!s) {
+        return NULL;
+    }
+    s->fp = fopen(filename, "rb");
+    if (!s->fp || fstat(fileno(s->fp), &st) != 0) {
+        maze_stream_close(s);
+        return NULL;
+    }
+
+    s->binary = fread(magic, 1, 4, s->fp) == 4 && memcmp(magic, BINARY_MAGIC, 4) == 0;
+    int err = fseeko(s->fp, 0, SEEK_SET) != 0;
+    if (!err) {
+        err = s->binary ? read_header(s, (size_t) st.st_size) : scan_text(s);
+    }
+    if (err) {
+        maze_stream_close(s);
+        return NULL;
+    }
+    s->stride = (s->n + WORD_BITS - 1) / WORD_BITS;
+    s->next_row = 0;
+    return s;
+}
+
+void maze_stream_close(struct maze_stream *s) {
+    if (s->fp) {
+        fclose(s->fp);
+    }
+    free(s->text);
+    free(s);
+}
+
+int maze_stream_size(const struct maze_stream *s) {
+    return s->n;
+}
+
+int maze_stream_stride(const struct maze_stream *s) {
+    return s->stride;
+}
+
+void maze_stream_start(const struct maze_stream *s, int *r, int *c) {
+    *r = (int) (s->start_index / (size_t) s->n);
+    *c = (int) (s->start_index % (size_t) s->n);
+}
+
+void maze_stream_destination(const struct maze_stream *s, int *r, int *c) {
+    *r = (int) (s->finish_index / (size_t) s->n);
+    *c = (int) (s->finish_index % (size_t) s->n);
+}
+
+bool maze_stream_is_binary(const struct maze_stream *s) {
+    return s->binary;
+}
+
+int maze_stream_write_binary(struct maze_stream *s, const char *filename) {
+    struct binary_header h = { BINARY_MAGIC, BINARY_ORDER, (uint32_t) s->n, BINARY_VERSION, s->start_index,
+                               s->finish_index };
+    size_t row_words = (size_t) s->stride;
+    int band = (int) (STREAM_BAND / (row_words * sizeof(uint64_t)));
+    if (band < 1) {
+        band = 1;
+    }
+
+    uint64_t *rows = malloc((size_t) band * row_words * sizeof(uint64_t));
+    FILE *fp = fopen(filename, "wb");
+    if (!rows || !fp) {
+        fprintf(stderr, "Cannot open file %s\n", filename);
+        free(rows);
+        if (fp) fclose(fp);
+        return 1;
+    }
+
+    bool ok = fwrite(&h, sizeof(h), 1, fp) == 1;
+    for (int r = 0; r < s->n && ok; r += band) {
+        int count = s->n - r < band ? s->n - r : band;
+        size_t words = (size_t) count * row_words;
+        ok = !maze_stream_rows(s, r, count, rows) && fwrite(rows, sizeof(uint64_t), words, fp) == words;
+    }
+
+    free(rows);
+    if (fclose(fp) != 0 || !ok) {
+        fprintf(stderr, "Cannot write file %s\n", filename);
+        return 1;
+    }
+    return 0;
+}
+
+int maze_stream_rows(struct maze_stream *s, int first, int count, uint64_t *rows) {
+    if (first < 0 || count <= 0 || count > s->n - first) {
+        return 1;
+    }
+    if (first != s->next_row && fseeko(s->fp, stream_offset(s, first), SEEK_SET) != 0) {
+        s->next_row = -1;
+        return 1;
+    }
+    s->next_row = -1;
+
+    size_t words = (size_t) count * (size_t) s->stride;
+    if (s->binary) {
+        if (fread(rows, sizeof(uint64_t), words, s->fp) != words) {
+            return 1;
+        }
+        int tail = s->n % WORD_BITS;
+        for (int i = 0; i < count && tail; i++) {
+            rows[(size_t) (i + 1) * (size_t) s->stride - 1] |= ~(uint64_t) 0 << tail;
+        }
+    } else {
+        size_t len = (size_t) s->n + 1;
+        size_t size = (size_t) count * len;
+        if (size > s->text_size) {
+            char *tmp = realloc(s->text, size);
+            if (!tmp) {
+                return 1;
+            }
+            s->text = tmp;
+            s->text_size = size;
+        }
+        if (fread(s->text, 1, size, s->fp) != size) {
+            return 1;
+        }
+        for (int i = 0; i < count; i++) {
+            parse_row(rows + (size_t) i * (size_t) s->stride, s->n, s->stride, s->text + (size_t) i * len);
+        }
+    }
+    s->next_row = first + count;
+    return 0;
+}
+
 void maze_start(const struct maze *m, int *r, int *c) {
     *r = maze_row(m, m->start_index);
     *c = maze_col(m, m->start_index);
@@ -221,10 +1005,46 @@ bool maze_valid_move(const struct maze *m, int r, int c) {
     return false;
 }
 
+bool maze_walkable(const struct maze *m, int r, int c) {
+    return maze_valid_move(m, r, c) && !maze_is_wall(m, r, c);
+}
+
 int maze_size(const struct maze *m) {
     return m->n;
 }
 
+int maze_cost(const struct maze *m, int r, int c) {
+    if (!m->cost) {
+        return 1;
+    }
+    int cost = m->cost[maze_index(m, r, c)];
+    return cost ? cost : 1;
+}
+
+int maze_max_cost(const struct maze *m) {
+    return m->max_cost;
+}
+
+#ifdef MAZE_TILED
+int maze_index(const struct maze *m, int r, int c) {
+    int tile = (r >> TILE_BITS) * m->tiles + (c >> TILE_BITS);
+    return tile << (2 * TILE_BITS) | (r & (TILE - 1)) << TILE_BITS | (c & (TILE - 1));
+}
+
+int maze_row(const struct maze *m, int index) {
+    int tile = index >> (2 * TILE_BITS);
+    return (tile / m->tiles) << TILE_BITS | ((index >> TILE_BITS) & (TILE - 1));
+}
+
+int maze_col(const struct maze *m, int index) {
+    int tile = index >> (2 * TILE_BITS);
+    return (tile % m->tiles) << TILE_BITS | (index & (TILE - 1));
+}
+
+size_t maze_cells(const struct maze *m) {
+    return (size_t) m->tiles * (size_t) m->tiles * TILE * TILE;
+}
+#else
 int maze_index(const struct maze *m, int r, int c) {
     return m->n * r + c;
 }
@@ -236,3 +1056,8 @@ int maze_row(const struct maze *m, int index) {
 int maze_col(const struct maze *m, int index) {
     return index % m->n;
 }
+
+size_t maze_cells(const struct maze *m) {
+    return (size_t) m->n * (size_t) m->n;
+}
+#endif
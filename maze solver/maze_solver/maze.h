@@ -1,8 +1,10 @@
-/* Do not edit this file. */
-
 #ifndef _MAZE_H_
 #define _MAZE_H_
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 /* Defines for ascii characters used in the maze array. */
 #define WALL '#'
 #define FLOOR ' '
@@ -19,10 +21,71 @@ extern int m_offsets[N_MOVES][2];
 struct maze;
 
 /* Reads a square maze from stdin. Start and destination markers are detected
- * and recorded. Everything that is not a WALL is stored as a FLOOR.
+ * and recorded. Everything that is not a WALL is stored as a FLOOR, and the
+ * digits '2' to '9' give their FLOOR cell that cost (see maze_cost()). If stdin
+ * is redirected from a file, the file is mapped into memory and parsed in
+ * place instead of being copied line by line. Mazes of more than 46336 cells
+ * a side, the largest multiple of 8 whose square fits in an int, do not fit
+ * the int cell indices of every layout (see maze_cells()) and are refused; a
+ * maze stream (below) can still read them. A maze with costs is also refused
+ * when its number of cells times its highest cost does not fit in an int, so
+ * the cost of every path does; with cost 9 that is 15446 cells a side.
  * Returns a pointer to the maze or NULL if an error occured. */
 struct maze *maze_read(void);
 
+/* Reads a square maze from the file 'filename' like maze_read().
+ * Returns a pointer to the maze or NULL if an error occured. */
+struct maze *maze_read_file(const char *filename);
+
+/* Binary mazes hold a small header with the size, start and destination,
+ * followed by the wall plane with one bit per cell in the layout described at
+ * maze_stride(). maze_read() and maze_read_file() detect them as well.
+ * maze_read_binary() only accepts a binary maze and maps the file so its wall
+ * plane is used in place. Changes to the maze never reach the file.
+ * Returns a pointer to the maze or NULL if an error occured. */
+struct maze *maze_read_binary(const char *filename);
+
+/* Writes the walls, start and destination of 'm' as a binary maze to
+ * 'filename'. Mazes with cell costs cannot be written.
+ * Returns 0 if successful, 1 if an error occured. */
+int maze_write_binary(const struct maze *m, const char *filename);
+
+/* A maze stream reads the walls of a text or binary maze file in bands of
+ * rows, for mazes that are too large to be loaded with maze_read(). Opening
+ * a text maze reads it once to find the start and destination; after that
+ * the file is only read by maze_stream_rows().
+ * Returns a pointer to the stream or NULL if an error occured. */
+struct maze_stream;
+struct maze_stream *maze_stream_open(const char *filename);
+
+/* Closes the file of the stream and frees its memory. */
+void maze_stream_close(struct maze_stream *s);
+
+/* Returns the size of the maze of the stream. */
+int maze_stream_size(const struct maze_stream *s);
+
+/* Returns the number of 64-bit words per row that maze_stream_rows() writes,
+ * like maze_stride(). */
+int maze_stream_stride(const struct maze_stream *s);
+
+/* Set 'r' and 'c' to the start and destination like maze_start() and
+ * maze_destination(). */
+void maze_stream_start(const struct maze_stream *s, int *r, int *c);
+void maze_stream_destination(const struct maze_stream *s, int *r, int *c);
+
+/* Returns true if the file of the stream is a binary maze. */
+bool maze_stream_is_binary(const struct maze_stream *s);
+
+/* Copies the maze of the stream to 'filename' as a binary maze, band by
+ * band, so a text maze that is read many times only has to be parsed once.
+ * Returns 0 if successful, 1 if an error occured. */
+int maze_stream_write_binary(struct maze_stream *s, const char *filename);
+
+/* Reads the walls of the 'count' rows from row 'first' on into 'rows', in
+ * the layout of maze_walls(). Reading the rows in order keeps the file access
+ * sequential. Returns 0 if successful, 1 if an error occured. */
+int maze_stream_rows(struct maze_stream *s, int first, int count, uint64_t *rows);
+
 /* Frees all memory associated with the maze. */
 void maze_cleanup(struct maze *m);
 
@@ -32,6 +95,26 @@ char maze_get(const struct maze *m, int r, int c);
 /* Sets the maze character at row 'r', column 'c' to 'value'. */
 void maze_set(struct maze *m, int r, int c, char value);
 
+/* Returns true if (r, c) is a WALL. Cheaper than comparing maze_get() with
+ * WALL because only the wall plane is read. */
+bool maze_is_wall(const struct maze *m, int r, int c);
+
+/* Returns a 4-bit mask of the neighbors of (r, c) that are not a WALL. Bit
+ * 'i' is set if the move m_offsets[i] leads to an open cell inside the grid. */
+unsigned maze_open_neighbors(const struct maze *m, int r, int c);
+
+/* The grid is stored as bit planes of 64-bit words and every row starts at a
+ * new word. maze_stride() returns the number of words per row and
+ * maze_walls() the wall plane, in which bit (c % 64) of word
+ * r * maze_stride() + c / 64 is set if (r, c) is a WALL. Bits behind the last
+ * column are set as well. */
+int maze_stride(const struct maze *m);
+const uint64_t *maze_walls(const struct maze *m);
+
+/* Returns a hash of the size and the walls of the maze, so files that hold
+ * data for one maze can refuse to be used with another. */
+uint64_t maze_walls_hash(const struct maze *m);
+
 /* Prints the maze to stdout. If 'blocks' is true walls are printed as a block
  * character, otherwise the WALL character '#' is used. */
 void maze_print(const struct maze *m, bool blocks);
@@ -58,12 +141,23 @@ bool maze_at_destination(const struct maze *m, int r, int c);
  * 0 and maze_size() - 1, are inaccessible. */
 bool maze_valid_move(const struct maze *m, int r, int c);
 
+/* Returns true if (r, c) may be entered: it is a valid move and not a WALL. */
+bool maze_walkable(const struct maze *m, int r, int c);
+
 /* Returns the size of the maze 'm'.
  *
  * We only support square mazes, so the size is the number of rows
  * which is also the number of columns. */
 int maze_size(const struct maze *m);
 
+/* Returns the cost of moving into (r, c), from 1 for a plain FLOOR up to
+ * maze_max_cost(). A path of only plain FLOOR cells costs its length. */
+int maze_cost(const struct maze *m, int r, int c);
+
+/* Returns the highest cost of any cell of the maze, 1 if all cells are plain
+ * FLOOR cells. */
+int maze_max_cost(const struct maze *m);
+
 /* Returns the index in the 1d array for row 'r' and column 'c'.
  *
  * Although there is no need to expose that the maze is internally stored
@@ -78,4 +172,12 @@ int maze_row(const struct maze *m, int index);
 /* Returns the column number of the 1d 'index'. */
 int maze_col(const struct maze *m, int index);
 
+/* Returns the number of indices maze_index() can return, which is the size
+ * that arrays indexed by maze_index() need. The indices are row-major unless
+ * the maze code is compiled with MAZE_TILED, which stores cells in 8 by 8
+ * tiles to keep vertical neighbors close together. Then the index space is
+ * rounded up to whole tiles and can be larger than maze_size() squared, and
+ * indices of cells outside the maze are never used. */
+size_t maze_cells(const struct maze *m);
+
 #endif
@@ -0,0 +1,397 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program solves a batch of maze files with a fixed pool of worker threads. The files are
+ * given as arguments; a directory stands for all .txt and .mazb files in it. A loader thread
+ * reads the mazes in order and keeps a few of them ready, so reading the next file overlaps with
+ * solving the current ones. Every worker keeps one set of breadth-first search buffers for all
+ * the mazes it solves and only grows them for a larger maze. For every maze one summary line
+ * with the path length, the number of expanded cells and the time of the search is printed, in
+ * the order of the input, as soon as all mazes before it are done.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <dirent.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "maze.h"
+#include "query.h"
+#include "solver.h"
+
+#define MAX_THREADS 256
+
+enum job_state { JOB_WAITING, JOB_LOADED, JOB_SOLVING, JOB_DONE };
+
+struct job {
+    const char *filename;
+    struct maze *m;
+    enum job_state state;
+    bool read_error;
+    int length;
+    long expanded;
+    double ms;
+};
+
+struct batch {
+    struct job *jobs;
+    int n_jobs;
+    int n_loaded;
+    int next_job;
+    int next_print;
+    int prefetch;
+    bool failed;
+    pthread_mutex_t lock;
+    pthread_cond_t loaded;
+    pthread_cond_t claimed;
+};
+
+/* Returns true if 'name' ends with 'suffix'. */
+static bool has_suffix(const char *name, const char *suffix) {
+    size_t n = strlen(name), k = strlen(suffix);
+    return n >= k && strcmp(name + n - k, suffix) == 0;
+}
+
+static int compare_names(const void *a, const void *b) {
+    return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+/**
+ * Appends a file name to a growing list of names.
+ *
+ * names: list of names, updated when it grows.
+ * n: number of names in the list, updated.
+ * cap: capacity of the list, updated.
+ * name: name to add, the list takes ownership of it.
+ *
+ * Returns:
+ * 0 if successful, 1 if memory could not be allocated.
+*/
+static int add_name(char ***names, int *n, int *cap, char *name) {
+    if (!name) return 1;
+    if (*n == *cap) {
+        int new_cap = *cap ? *cap * 2 : 16;
+        char **tmp = realloc(*names, sizeof(char *) * (size_t) new_cap);
+        if (!tmp) {
+            free(name);
+            return 1;
+        }
+        *names = tmp;
+        *cap = new_cap;
+    }
+    (*names)[(*n)++] = name;
+    return 0;
+}
+
+/* Returns a new copy of the path 'dir'/'name', or NULL if it could not be allocated. */
+static char *join_path(const char *dir, const char *name) {
+    size_t len = strlen(dir) + strlen(name) + 2;
+    char *path = malloc(len);
+    if (path) {
+        snprintf(path, len, "%s/%s", dir, name);
+    }
+    return path;
+}
+
+/**
+ * Appends the .txt and .mazb files of a directory in alphabetical order to a list of names.
+ *
+ * names, n, cap: list of names, updated.
+ * path: name of the directory.
+ * dir: the opened directory.
+ *
+ * Returns:
+ * 0 if successful, 1 if memory could not be allocated.
+*/
+static int add_directory(char ***names, int *n, int *cap, const char *path, DIR *dir) {
+    int first = *n;
+    struct dirent *e;
+
+    while ((e = readdir(dir)) != NULL) {
+        if (e->d_name[0] == '.' || !(has_suffix(e->d_name, ".txt") || has_suffix(e->d_name, ".mazb"))) {
+            continue;
+        }
+        if (add_name(names, n, cap, join_path(path, e->d_name))) return 1;
+    }
+
+    qsort(*names + first, (size_t) (*n - first), sizeof(char *), compare_names);
+    return 0;
+}
+
+/**
+ * Collects the maze files named by the arguments. A directory is replaced by its maze files.
+ *
+ * args: file and directory names.
+ * n_args: number of names.
+ * names: receives a new list of new strings.
+ * n_names: receives the number of maze files.
+ *
+ * Returns:
+ * 0 if successful, 1 if memory could not be allocated.
+*/
+static int collect_files(char **args, int n_args, char ***names, int *n_names) {
+    int n = 0, cap = 0, err = 0;
+
+    *names = NULL;
+    for (int i = 0; i < n_args && !err; i++) {
+        struct stat st;
+        DIR *dir = NULL;
+
+        if (stat(args[i], &st) == 0 && S_ISDIR(st.st_mode)) {
+            dir = opendir(args[i]);
+        }
+        if (dir) {
+            err = add_directory(names, &n, &cap, args[i], dir);
+            closedir(dir);
+        } else {
+            /* Files that cannot be read are reported by the loader. */
+            char *copy = malloc(strlen(args[i]) + 1);
+            if (copy) strcpy(copy, args[i]);
+            err = add_name(names, &n, &cap, copy);
+        }
+    }
+
+    if (err) {
+        for (int i = 0; i < n; i++) {
+            free((*names)[i]);
+        }
+        free(*names);
+        *names = NULL;
+        n = 0;
+    }
+    *n_names = n;
+    return err;
+}
+
+/* Returns the time of the monotonic clock in milliseconds. */
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e3 + (double) ts.tv_nsec / 1e6;
+}
+
+/* Prints the summary line of job 'j'. */
+static void print_job(const struct job *j) {
+    if (j->read_error) {
+        printf("%s: error reading maze\n", j->filename);
+    } else if (j->length == ERROR) {
+        printf("%s: bfs failed\n", j->filename);
+    } else if (j->length == NOT_FOUND) {
+        printf("%s: no path found, expanded %ld cells in %.3f ms\n", j->filename, j->expanded, j->ms);
+    } else {
+        printf("%s: length %d, expanded %ld cells in %.3f ms\n", j->filename, j->length, j->expanded,
+               j->ms);
+    }
+}
+
+/**
+ * Reads the mazes in order, while keeping at most 'prefetch' of them loaded but not yet claimed
+ * by a worker.
+ *
+ * arg: batch.
+*/
+static void *loader(void *arg) {
+    struct batch *b = arg;
+
+    for (int i = 0; i < b->n_jobs; i++) {
+        pthread_mutex_lock(&b->lock);
+        while (b->n_loaded - b->next_job >= b->prefetch) {
+            pthread_cond_wait(&b->claimed, &b->lock);
+        }
+        pthread_mutex_unlock(&b->lock);
+
+        struct maze *m = maze_read_file(b->jobs[i].filename);
+
+        pthread_mutex_lock(&b->lock);
+        b->jobs[i].m = m;
+        b->jobs[i].read_error = m == NULL;
+        b->jobs[i].state = JOB_LOADED;
+        b->n_loaded++;
+        pthread_cond_broadcast(&b->loaded);
+        pthread_mutex_unlock(&b->lock);
+    }
+    return NULL;
+}
+
+/**
+ * Solves job 'j' with the buffers 'q', which are created or grown for the maze as needed.
+ *
+ * j: job with a loaded maze.
+ * q: search buffers of the worker, updated.
+*/
+static void solve_job(struct job *j, struct query **q) {
+    int r = 0, c = 0, dest_r = 0, dest_c = 0;
+
+    if (!*q) {
+        *q = query_init(j->m);
+    } else if (query_reset(*q, j->m)) {
+        query_cleanup(*q);
+        *q = NULL;
+    }
+    if (!*q) {
+        j->length = ERROR;
+        return;
+    }
+
+    maze_start(j->m, &r, &c);
+    maze_destination(j->m, &dest_r, &dest_c);
+
+    double start = now_ms();
+    j->length = query_length(*q, maze_index(j->m, r, c), maze_index(j->m, dest_r, dest_c));
+    j->ms = now_ms() - start;
+    j->expanded = query_expanded(*q);
+}
+
+/**
+ * Takes loaded mazes in input order and solves them until all jobs are claimed. Finished jobs
+ * are printed as soon as every job before them is printed.
+ *
+ * arg: batch.
+*/
+static void *worker(void *arg) {
+    struct batch *b = arg;
+    struct query *q = NULL;
+
+    pthread_mutex_lock(&b->lock);
+    while (b->next_job < b->n_jobs) {
+        if (b->next_job == b->n_loaded) {
+            pthread_cond_wait(&b->loaded, &b->lock);
+            continue;
+        }
+
+        struct job *j = &b->jobs[b->next_job++];
+        j->state = JOB_SOLVING;
+        pthread_cond_signal(&b->claimed);
+        pthread_mutex_unlock(&b->lock);
+
+        if (j->m) {
+            solve_job(j, &q);
+            maze_cleanup(j->m);
+            j->m = NULL;
+        }
+
+        pthread_mutex_lock(&b->lock);
+        j->state = JOB_DONE;
+        if (j->read_error || j->length == ERROR) {
+            b->failed = true;
+        }
+        while (b->next_print < b->n_jobs && b->jobs[b->next_print].state == JOB_DONE) {
+            print_job(&b->jobs[b->next_print++]);
+        }
+    }
+    pthread_mutex_unlock(&b->lock);
+
+    query_cleanup(q);
+    return NULL;
+}
+
+/**
+ * Solves all files with 'n_threads' workers and one loader thread.
+ *
+ * files: names of the maze files.
+ * n_files: number of files.
+ * n_threads: number of workers.
+ *
+ * Returns:
+ * 0 if every maze was read and searched, 1 otherwise.
+*/
+static int run_batch(char **files, int n_files, int n_threads) {
+    struct batch b = { 0 };
+    pthread_t load_thread;
+
+    if (n_files == 0) {
+        return 0;
+    }
+
+    pthread_t *threads = malloc(sizeof(pthread_t) * (size_t) n_threads);
+
+    b.jobs = calloc((size_t) n_files, sizeof(struct job));
+    if (!threads || !b.jobs) {
+        free(threads);
+        free(b.jobs);
+        return 1;
+    }
+    for (int i = 0; i < n_files; i++) {
+        b.jobs[i].filename = files[i];
+    }
+    b.n_jobs = n_files;
+    b.prefetch = n_threads;
+    pthread_mutex_init(&b.lock, NULL);
+    pthread_cond_init(&b.loaded, NULL);
+    pthread_cond_init(&b.claimed, NULL);
+
+    int started = 0;
+    bool loading = pthread_create(&load_thread, NULL, loader, &b) == 0;
+    if (loading) {
+        while (started < n_threads && pthread_create(&threads[started], NULL, worker, &b) == 0) {
+            started++;
+        }
+        /* With no threads at all, the main thread does the work itself. */
+        if (started == 0) {
+            worker(&b);
+        }
+    }
+    for (int t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    if (loading) {
+        pthread_join(load_thread, NULL);
+    }
+
+    int err = !loading || b.failed;
+    pthread_cond_destroy(&b.claimed);
+    pthread_cond_destroy(&b.loaded);
+    pthread_mutex_destroy(&b.lock);
+    free(b.jobs);
+    free(threads);
+    return err;
+}
+
+int main(int argc, char *argv[]) {
+    long n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    int first_file = 1;
+
+    if (argc > 2 && strcmp(argv[1], "--threads") == 0) {
+        char *end;
+        n_threads = strtol(argv[2], &end, 10);
+        if (*end != '\0' || n_threads < 1 || n_threads > MAX_THREADS) {
+            fprintf(stderr, "--threads expects a number from 1 to %d\n", MAX_THREADS);
+            return 1;
+        }
+        first_file = 3;
+    }
+    if (first_file >= argc || argv[first_file][0] == '-') {
+        fprintf(stderr, "usage: %s [--threads N] maze|directory...\n", argv[0]);
+        return 1;
+    }
+    if (n_threads < 1) {
+        n_threads = 1;
+    } else if (n_threads > MAX_THREADS) {
+        n_threads = MAX_THREADS;
+    }
+
+    int n_files;
+    char **files;
+    if (collect_files(argv + first_file, argc - first_file, &files, &n_files)) {
+        fprintf(stderr, "Error collecting maze files\n");
+        return 1;
+    }
+
+    int err = run_batch(files, n_files, (int) n_threads);
+
+    for (int i = 0; i < n_files; i++) {
+        free(files[i]);
+    }
+    free(files);
+    return err;
+}
@@ -0,0 +1,35 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program converts a maze to the binary maze format. The binary format stores one bit per
+ * cell instead of one character, and the solvers can use its wall plane straight from the file
+ * without parsing it, which makes loading large mazes a lot faster. The program reads a maze in
+ * either format from stdin and writes it as a binary maze to the file given as argument.
+*/
+
+#include <stdio.h>
+
+#include "maze.h"
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s output < maze\n", argv[0]);
+        return 1;
+    }
+
+    /* read maze */
+    struct maze *m = maze_read();
+    if (!m) {
+        printf("Error reading maze\n");
+        return 1;
+    }
+
+    /* write binary maze */
+    int err = maze_write_binary(m, argv[1]);
+
+    maze_cleanup(m);
+    return err;
+}
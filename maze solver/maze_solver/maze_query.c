@@ -0,0 +1,252 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program answers many route queries on one maze. The maze is read once from the file given
+ * as argument and is never changed, after which every line "sr sc dr dc" on stdin asks for the
+ * length of the shortest path from (sr, sc) to (dr, dc). One length is printed per query, or -1
+ * if there is no path. By default every query runs a breadth-first search with epoch-stamped
+ * scratch buffers. With --graph the maze is first contracted into its junction graph and every
+ * query runs Dijkstra's algorithm on that graph instead. With --hpa SIZE the maze is cut into
+ * clusters of SIZE by SIZE cells and every query runs A* on the cluster abstraction of hpa.c,
+ * which answers with the length of a path that may be a few moves longer than the shortest one.
+ *
+ * Before any search, the connected component labels of the maze tell whether the two cells can
+ * reach each other at all, so unreachable queries never start a search. With --labels FILE the
+ * labels are loaded from FILE, or computed once and saved there if FILE does not hold the labels
+ * of this maze yet.
+ *
+ * With --distances FILE the distance field saved by maze_solver_bfs --distances is mapped, and
+ * every query that starts or ends at its source is answered with one read from the field.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "components.h"
+#include "distance.h"
+#include "graph.h"
+#include "hpa.h"
+#include "maze.h"
+#include "query.h"
+#include "solver.h"
+
+#define MAX_CLUSTER_SIZE 1024
+
+/**
+ * Converts a query to the index of its cell.
+ *
+ * m: maze.
+ * r: row of the cell.
+ * c: column of the cell.
+ *
+ * Returns:
+ * the index of the cell, or -1 if it lies outside of the maze.
+*/
+static int query_cell(const struct maze *m, int r, int c) {
+    if (r < 0 || r >= maze_size(m) || c < 0 || c >= maze_size(m)) {
+        return -1;
+    }
+    return maze_index(m, r, c);
+}
+
+/**
+ * Loads the connected component labels of the maze from 'filename', or computes them and saves
+ * them there if the file does not hold the labels of this maze.
+ *
+ * m: maze.
+ * filename: label file, or NULL to only compute the labels.
+ *
+ * Returns:
+ * the labels, or NULL if an error occured.
+*/
+static struct components *get_labels(const struct maze *m, const char *filename) {
+    struct components *cc = filename ? components_load(m, filename) : NULL;
+    if (cc) {
+        return cc;
+    }
+
+    cc = components_label(m);
+    if (cc && filename && components_save(cc, filename)) {
+        components_cleanup(cc);
+        return NULL;
+    }
+    return cc;
+}
+
+/**
+ * Looks a query up in the distance field. Paths are the same in both directions, so a query that
+ * ends at the source of the field is answered as well.
+ *
+ * d: distance field, or NULL.
+ * sr, sc: start of the query.
+ * dr, dc: destination of the query.
+ * len: receives the length of the path or NOT_FOUND.
+ *
+ * Returns:
+ * true if the query was answered from the field.
+*/
+static bool lookup_distance(const struct distances *d, int sr, int sc, int dr, int dc, int *len) {
+    int r = 0, c = 0;
+
+    if (!d) {
+        return false;
+    }
+    distances_source(d, &r, &c);
+    if (sr == r && sc == c) {
+        *len = distances_get(d, dr, dc);
+    } else if (dr == r && dc == c) {
+        *len = distances_get(d, sr, sc);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Reads queries from stdin until the end of the input and prints the length of each of them.
+ *
+ * m: maze.
+ * cc: connected component labels of the maze.
+ * d: distance field of the maze, or NULL.
+ * q: scratch buffers of the breadth-first search, or NULL.
+ * s: scratch buffers of the graph search, or NULL.
+ * hs: scratch buffers of the cluster abstraction search, used if 'q' and 's' are NULL.
+ *
+ * Returns:
+ * 0 if successful, 1 if a query could not be read or answered.
+*/
+static int run_queries(const struct maze *m, const struct components *cc, const struct distances *d,
+                       struct query *q, struct graph_search *s, struct hpa_search *hs) {
+    int sr, sc, dr, dc, n;
+
+    while ((n = scanf("%d %d %d %d", &sr, &sc, &dr, &dc)) == 4) {
+        int start = query_cell(m, sr, sc);
+        int dest = query_cell(m, dr, dc);
+        int len = NOT_FOUND;
+
+        if (!lookup_distance(d, sr, sc, dr, dc, &len) && start >= 0 && dest >= 0
+            && components_connected(cc, start, dest)) {
+            if (q) {
+                len = query_length(q, start, dest);
+            } else if (s) {
+                len = graph_query(s, start, dest);
+            } else {
+                len = hpa_query(hs, start, dest);
+            }
+        }
+        if (len == ERROR) {
+            fprintf(stderr, "query failed\n");
+            return 1;
+        }
+        printf("%d\n", len < 0 ? -1 : len);
+    }
+
+    if (n != EOF) {
+        fprintf(stderr, "queries must be lines of the form: sr sc dr dc\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    bool use_graph = false;
+    int cluster_size = 0;
+    const char *filename = NULL;
+    const char *labels = NULL;
+    const char *distances = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--graph") == 0) {
+            use_graph = true;
+        } else if (strcmp(argv[i], "--hpa") == 0 && i + 1 < argc) {
+            char *end;
+            long n = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || n < 1 || n > MAX_CLUSTER_SIZE) {
+                fprintf(stderr, "--hpa expects a number from 1 to %d\n", MAX_CLUSTER_SIZE);
+                return 1;
+            }
+            cluster_size = (int) n;
+        } else if (strcmp(argv[i], "--labels") == 0 && i + 1 < argc) {
+            labels = argv[++i];
+        } else if (strcmp(argv[i], "--distances") == 0 && i + 1 < argc) {
+            distances = argv[++i];
+        } else if (filename == NULL && argv[i][0] != '-') {
+            filename = argv[i];
+        } else {
+            filename = NULL;
+            break;
+        }
+    }
+    if (filename == NULL || (use_graph && cluster_size)) {
+        fprintf(stderr, "usage: %s [--graph | --hpa SIZE] [--labels FILE] [--distances FILE] maze < queries\n",
+                argv[0]);
+        return 1;
+    }
+
+    /* read maze */
+    struct maze *m = maze_read_file(filename);
+    if (!m) {
+        printf("Error reading maze\n");
+        return 1;
+    }
+
+    struct components *cc = get_labels(m, labels);
+    if (!cc) {
+        fprintf(stderr, "labeling failed\n");
+        maze_cleanup(m);
+        return 1;
+    }
+
+    struct distances *d = NULL;
+    if (distances) {
+        d = distances_load(m, distances);
+        if (!d) {
+            fprintf(stderr, "%s does not hold the distances of this maze\n", distances);
+            components_cleanup(cc);
+            maze_cleanup(m);
+            return 1;
+        }
+    }
+
+    /* answer queries */
+    int err = 1;
+    if (use_graph) {
+        struct graph *g = graph_build(m);
+        struct graph_search *s = g ? graph_search_init(g) : NULL;
+        if (s) {
+            err = run_queries(m, cc, d, NULL, s, NULL);
+        } else {
+            fprintf(stderr, "graph failed\n");
+        }
+        graph_search_cleanup(s);
+        graph_cleanup(g);
+    } else if (cluster_size) {
+        struct hpa *h = hpa_build(m, cluster_size);
+        struct hpa_search *hs = h ? hpa_search_init(h) : NULL;
+        if (hs) {
+            err = run_queries(m, cc, d, NULL, NULL, hs);
+        } else {
+            fprintf(stderr, "hpa failed\n");
+        }
+        hpa_search_cleanup(hs);
+        hpa_cleanup(h);
+    } else {
+        struct query *q = query_init(m);
+        if (q) {
+            err = run_queries(m, cc, d, q, NULL, NULL);
+        } else {
+            fprintf(stderr, "query failed\n");
+        }
+        query_cleanup(q);
+    }
+
+    distances_cleanup(d);
+    components_cleanup(cc);
+    maze_cleanup(m);
+    return err;
+}
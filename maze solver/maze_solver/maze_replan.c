@@ -0,0 +1,297 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program solves a maze with an incremental search session (lpa.c) and measures how fast it
+ * repairs the path while doors open and close. Without options it solves the maze once and
+ * prints the results like the other solvers.
+ *
+ * With --edits N it makes N edits to the maze instead. Every edit either closes a random cell of
+ * the current path or opens a door it closed before, so most edits really change the path. After
+ * every edit the session repairs its path, and a breadth-first search from scratch (query.c)
+ * solves the maze again for comparison. Both must find the same length. The time per edit of
+ * both, and the cells they expanded, are printed at the end. --seed S picks the series of edits.
+ *
+ * With --stats=json the measurements of the single solve are printed to stderr as well.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "lpa.h"
+#include "maze.h"
+#include "metrics.h"
+#include "query.h"
+#include "solver.h"
+
+#define MAX_EDITS 10000000
+
+/* Measurements of the run for --stats=json, or NULL if they are not collected. */
+static struct metrics *run_stats = NULL;
+
+/* Measurements of one way of solving the maze after every edit. */
+struct timing {
+    double *ms;
+    long expanded;
+};
+
+/* State of the benchmark. */
+struct replan {
+    struct maze *m;
+    struct lpa *s;
+    struct query *q;
+    int start;
+    int dest;
+    int *path;
+    int *doors;
+    int n_doors;
+    int closed;
+    int opened;
+};
+
+/* Returns the time of the monotonic clock in milliseconds. */
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e3 + (double) ts.tv_nsec / 1e6;
+}
+
+/* Compares two doubles for qsort(). */
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+/* Returns the cells of the current path between the start and the destination in p->path, and
+ * their number. */
+static int path_cells(struct replan *p) {
+    int n = 0;
+
+    for (int idx = lpa_predecessor(p->s, p->dest); idx != -1 && idx != p->start;
+         idx = lpa_predecessor(p->s, idx)) {
+        p->path[n++] = idx;
+    }
+    return n;
+}
+
+/**
+ * Makes one edit: opens a random closed door half of the time, or when the path cannot be
+ * closed any further, and closes a random cell of the current path otherwise.
+ *
+ * p: benchmark state.
+ *
+ * Returns:
+ * 0 if successful, 1 if an error occured.
+*/
+static int edit(struct replan *p) {
+    int n_path = path_cells(p);
+    bool open = p->n_doors > 0 && (n_path == 0 || rand() % 2 == 0);
+    int idx;
+
+    if (open) {
+        int i = rand() % p->n_doors;
+        idx = p->doors[i];
+        p->doors[i] = p->doors[--p->n_doors];
+        p->opened++;
+    } else if (n_path > 0) {
+        idx = p->path[rand() % n_path];
+        p->doors[p->n_doors++] = idx;
+        p->closed++;
+    } else {
+        return 0;
+    }
+    return lpa_set_wall(p->s, maze_row(p->m, idx), maze_col(p->m, idx), !open);
+}
+
+/* Prints the median, 95th percentile and mean of the times of 't', and the cells it expanded
+ * per edit. */
+static void print_timing(const char *name, struct timing *t, int n_edits) {
+    double sum = 0;
+
+    for (int i = 0; i < n_edits; i++) {
+        sum += t->ms[i];
+    }
+    qsort(t->ms, (size_t) n_edits, sizeof(double), compare_double);
+    printf("%s: median %.4f ms, p95 %.4f ms, mean %.4f ms per edit, %.1f cells expanded per edit\n", name,
+           t->ms[n_edits / 2], t->ms[n_edits * 95 / 100], sum / n_edits, (double) t->expanded / n_edits);
+}
+
+/**
+ * Makes 'n_edits' edits, repairs the path after each of them and solves the maze again from
+ * scratch, and prints the times of both.
+ *
+ * p: benchmark state with a solved session.
+ * n_edits: number of edits.
+ *
+ * Returns:
+ * 0 if successful, 1 if an error occured or the lengths differ.
+*/
+static int run_edits(struct replan *p, int n_edits) {
+    struct timing lpa = { malloc(sizeof(double) * (size_t) n_edits), 0 };
+    struct timing bfs = { malloc(sizeof(double) * (size_t) n_edits), 0 };
+    int err = !lpa.ms || !bfs.ms;
+
+    for (int i = 0; i < n_edits && !err; i++) {
+        double t0 = now_ms();
+        err = edit(p);
+        int len = err ? ERROR : lpa_solve(p->s);
+        double t1 = now_ms();
+        int ref = query_length(p->q, p->start, p->dest);
+        double t2 = now_ms();
+
+        lpa.ms[i] = t1 - t0;
+        lpa.expanded += lpa_expanded(p->s);
+        bfs.ms[i] = t2 - t1;
+        bfs.expanded += query_expanded(p->q);
+        if (len == ERROR) {
+            fprintf(stderr, "lpa failed\n");
+            err = 1;
+        } else if (len != ref) {
+            fprintf(stderr, "lpa found length %d after edit %d, bfs found %d\n", len, i + 1, ref);
+            err = 1;
+        }
+    }
+
+    if (!err) {
+        printf("edits: %d (%d closed, %d opened)\n", n_edits, p->closed, p->opened);
+        print_timing("lpa", &lpa, n_edits);
+        print_timing("bfs", &bfs, n_edits);
+        double median = lpa.ms[n_edits / 2] > 0 ? lpa.ms[n_edits / 2] : 1e-6;
+        printf("speedup: %.1fx (median)\n", bfs.ms[n_edits / 2] / median);
+    }
+    free(lpa.ms);
+    free(bfs.ms);
+    return err;
+}
+
+/**
+ * Solves the maze once, then runs the benchmark if 'n_edits' is positive.
+ *
+ * m: maze.
+ * n_edits: number of edits.
+ *
+ * Returns:
+ * the length of the path if a path is found, or 0 after a benchmark.
+ * NOT_FOUND if no path is found and ERROR if an error occured or the benchmark failed.
+*/
+static int replan(struct maze *m, int n_edits) {
+    struct replan p;
+    int r = 0, c = 0;
+
+    memset(&p, 0, sizeof(p));
+    p.m = m;
+    p.s = lpa_init(m);
+    p.q = n_edits > 0 ? query_init(m) : NULL;
+    p.path = malloc(sizeof(int) * maze_cells(m));
+    p.doors = malloc(sizeof(int) * ((size_t) n_edits + 1));
+    maze_start(m, &r, &c);
+    p.start = maze_index(m, r, c);
+    maze_destination(m, &r, &c);
+    p.dest = maze_index(m, r, c);
+
+    int len = ERROR;
+    if (p.s && (p.q || n_edits == 0) && p.path && p.doors) {
+        lpa_measure(p.s, run_stats);
+        len = lpa_solve(p.s);
+        lpa_measure(p.s, NULL);
+    }
+    if (len >= 0 && n_edits > 0) {
+        len = run_edits(&p, n_edits) ? ERROR : 0;
+    } else if (len >= 0) {
+        double t0 = metrics_now_ms();
+        lpa_paint(p.s, m);
+        if (run_stats) {
+            run_stats->path_ms = metrics_now_ms() - t0;
+        }
+    }
+
+    lpa_cleanup(p.s);
+    query_cleanup(p.q);
+    free(p.path);
+    free(p.doors);
+    return len;
+}
+
+int main(int argc, char *argv[]) {
+    long n_edits = 0;
+    unsigned seed = 1;
+    bool json = false;
+
+    for (int i = 1; i < argc; i++) {
+        char *end = NULL;
+        if (strcmp(argv[i], "--edits") == 0 && i + 1 < argc) {
+            n_edits = strtol(argv[++i], &end, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned) strtoul(argv[++i], &end, 10);
+        } else if (strcmp(argv[i], "--stats=json") == 0) {
+            json = true;
+            continue;
+        }
+        if (!end || *end != '\0' || n_edits < 0 || n_edits > MAX_EDITS) {
+            n_edits = -1;
+            break;
+        }
+    }
+    /* Only the single solve is measured, the benchmark prints its own times. */
+    if (n_edits < 0 || (json && n_edits > 0)) {
+        fprintf(stderr, "usage: %s [--edits N] [--seed S] < maze\n"
+                "       %s [--stats=json] < maze\n", argv[0], argv[0]);
+        return 1;
+    }
+    srand(seed);
+
+    struct metrics stats;
+    metrics_init(&stats);
+    run_stats = json ? &stats : NULL;
+    double t0 = metrics_now_ms();
+
+    /* read maze */
+    struct maze *m = maze_read();
+    if (!m) {
+        printf("Error reading maze\n");
+        return 1;
+    }
+    stats.load_ms = metrics_now_ms() - t0;
+    stats.size = maze_size(m);
+    if (n_edits > 0 && maze_max_cost(m) > 1) {
+        fprintf(stderr, "the breadth-first search to compare with needs a maze without cell costs\n");
+        maze_cleanup(m);
+        return 1;
+    }
+
+    /* solve maze */
+    t0 = metrics_now_ms();
+    int path_length = replan(m, (int) n_edits);
+    stats.search_ms = metrics_now_ms() - t0 - stats.path_ms;
+    if (json && path_length != ERROR) {
+        metrics_print_json(&stats, stderr, "lpa", path_length);
+    }
+    metrics_cleanup(&stats);
+    if (path_length == ERROR) {
+        printf("lpa failed\n");
+        maze_cleanup(m);
+        return 1;
+    } else if (path_length == NOT_FOUND) {
+        printf("no path found from start to destination\n");
+        maze_cleanup(m);
+        return 1;
+    } else if (n_edits > 0) {
+        maze_cleanup(m);
+        return 0;
+    }
+    printf("lpa found a path of length: %d\n", path_length);
+
+    /* print maze */
+    maze_print(m, false);
+    maze_output_ppm(m, "out.ppm");
+
+    maze_cleanup(m);
+    return 0;
+}
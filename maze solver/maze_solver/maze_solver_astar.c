@@ -0,0 +1,250 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program uses the A* search algorithm to solve a maze. Cells are expanded in the order of
+ * their distance from the start plus the Manhattan distance to the destination, which never
+ * overestimates the remaining path in a four-connected maze. The shortest path is therefore still
+ * found, while cells that lead away from the destination are mostly never expanded. The open set
+ * is an indexed binary heap, so a cell that is reached again over a shorter path gets its key
+ * lowered instead of being queued twice. The program reads the maze, applies A*, and prints the
+ * results.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "iheap.h"
+#include "jps.h"
+#include "maze.h"
+#include "metrics.h"
+#include "solver.h"
+
+#define VALID_MOVES 4
+
+/* Measurements of the run for --stats=json, or NULL if they are not collected. */
+static struct metrics *run_stats = NULL;
+
+/**
+ * Computes the Manhattan distance between two cells, the heuristic of the search.
+ * 
+ * m: maze.
+ * idx: index of the cell.
+ * dest_r: row of the destination.
+ * dest_c: column of the destination.
+ * 
+ * Returns:
+ * the number of moves from the cell to the destination if there were no walls.
+*/
+static int manhattan(const struct maze *m, int idx, int dest_r, int dest_c) {
+    return abs(maze_row(m, idx) - dest_r) + abs(maze_col(m, idx) - dest_c);
+}
+
+/**
+ * Builds the heap key of a cell. Cells are ordered on f = g + h, and among equal f the cell closest
+ * to the destination goes first, which keeps the search on one of the shortest paths.
+ * 
+ * g: length of the path from the start to the cell.
+ * h: heuristic distance from the cell to the destination.
+ * 
+ * Returns:
+ * the key of the cell in the open set.
+*/
+static uint64_t make_key(int g, int h) {
+    return (uint64_t) (g + h) << 32 | (uint32_t) h;
+}
+
+/**
+ * Looks for all adjacent nodes that are not expanded yet, and adds them to the open set or
+ * lowers their key when they are reached over a shorter path.
+ * 
+ * m: maze.
+ * cur: index of the current cell.
+ * h: open set.
+ * g: length of the path to every cell plus one, 0 if the cell is not reached yet.
+ * p: array of predecessor node
+ * dest_r: row of the destination.
+ * dest_c: column of the destination.
+ * 
+ * Returns:
+ * 0 if successful, 1 if the open set could not grow.
+*/
+int node_search(struct maze *m, int cur, struct iheap *h, int *g, int *p, int dest_r, int dest_c) {
+    int r = maze_row(m, cur);
+    int c = maze_col(m, cur);
+    unsigned open = maze_open_neighbors(m, r, c);
+
+    for (int i = 0; i < VALID_MOVES; i++) {
+        if (!((open >> i) & 1)) continue;
+
+        int r_new = r + m_offsets[i][0];
+        int c_new = c + m_offsets[i][1];
+        if (!maze_valid_move(m, r_new, c_new) || maze_get(m, r_new, c_new) == VISITED) continue;
+
+        int idx = maze_index(m, r_new, c_new);
+        int g_new = g[cur];
+        if (g[idx] != 0 && g[idx] - 1 <= g_new) continue;
+
+        if (iheap_push(h, idx, make_key(g_new, manhattan(m, idx, dest_r, dest_c)))) return 1;
+        g[idx] = g_new + 1;
+        p[idx] = cur;
+        maze_set(m, r_new, c_new, TO_VISIT);
+    }
+
+    return 0;
+}
+
+/**
+ * Draws the path by following the predecessors from the destination back to the start.
+ * 
+ * m: maze
+ * p: prev array
+ * idx: index of the destination.
+ * 
+ * Returns:
+ * Total length of the shortest path.
+*/
+int shortest_path(struct maze *m, const int *p, int idx) {
+    int len = 0;
+
+    while (!maze_at_start(m, maze_row(m, idx), maze_col(m, idx))) {
+        maze_set(m, maze_row(m, idx), maze_col(m, idx), PATH);
+        idx = p[idx];
+        len++;
+    }
+
+    return len;
+}
+
+/* Solves the maze m.
+ * Returns the length of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occured.
+ */
+int astar_solve(struct maze *m) {
+    size_t cells = maze_cells(m);
+    struct iheap *h = iheap_init(cells);
+    int *g = calloc(cells, sizeof(int));
+    int *prev = malloc(sizeof(int) * cells);
+    int r = 0, c = 0, dest_r = 0, dest_c = 0;
+    int len = NOT_FOUND;
+
+    if (h == NULL || g == NULL || prev == NULL) {
+        iheap_cleanup(h);
+        free(g);
+        free(prev);
+        return ERROR;
+    }
+
+    maze_destination(m, &dest_r, &dest_c);
+    maze_start(m, &r, &c);
+    int start = maze_index(m, r, c);
+    g[start] = 1;
+    iheap_push(h, start, make_key(0, manhattan(m, start, dest_r, dest_c)));
+
+    while (!iheap_empty(h)) {
+        size_t frontier = iheap_size(h);
+        int cur = iheap_pop(h);
+        r = maze_row(m, cur);
+        c = maze_col(m, cur);
+        maze_set(m, r, c, VISITED);
+
+        if (run_stats && metrics_expand(run_stats, g[cur] - 1, frontier)) {
+            len = ERROR;
+            break;
+        }
+
+        if (maze_at_destination(m, r, c)) {
+            double t0 = metrics_now_ms();
+            len = shortest_path(m, prev, cur);
+            if (run_stats) {
+                run_stats->path_ms = metrics_now_ms() - t0;
+            }
+            break;
+        }
+
+        if (node_search(m, cur, h, g, prev, dest_r, dest_c)) {
+            len = ERROR;
+            break;
+        }
+    }
+
+    if (run_stats) {
+        run_stats->bytes = iheap_bytes(h) + 2 * sizeof(int) * cells;
+    }
+    iheap_cleanup(h);
+    free(g);
+    free(prev);
+    return len;
+}
+
+/* Solves the maze m with Jump Point Search, measured into run_stats if it is set. */
+static int jps_measured_solve(struct maze *m) {
+    return jps_solve(m, run_stats);
+}
+
+int main(int argc, char *argv[]) {
+    int (*solve)(struct maze *) = astar_solve;
+    const char *name = "astar";
+    bool json = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--jps") == 0) {
+            solve = jps_measured_solve;
+            name = "astar_jps";
+        } else if (strcmp(argv[i], "--stats=json") == 0) {
+            json = true;
+        } else {
+            solve = NULL;
+            break;
+        }
+    }
+    if (!solve) {
+        fprintf(stderr, "usage: %s [--jps] [--stats=json] < maze\n", argv[0]);
+        return 1;
+    }
+
+    struct metrics stats;
+    metrics_init(&stats);
+    run_stats = json ? &stats : NULL;
+    double t0 = metrics_now_ms();
+
+    /* read maze */
+    struct maze *m = maze_read();
+    if (!m) {
+        printf("Error reading maze\n");
+        return 1;
+    }
+    stats.load_ms = metrics_now_ms() - t0;
+    stats.size = maze_size(m);
+
+    /* solve maze */
+    t0 = metrics_now_ms();
+    int path_length = solve(m);
+    stats.search_ms = metrics_now_ms() - t0 - stats.path_ms;
+    if (json && path_length != ERROR) {
+        metrics_print_json(&stats, stderr, name, path_length);
+    }
+    metrics_cleanup(&stats);
+    if (path_length == ERROR) {
+        printf("astar failed\n");
+        maze_cleanup(m);
+        return 1;
+    } else if (path_length == NOT_FOUND) {
+        printf("no path found from start to destination\n");
+        maze_cleanup(m);
+        return 1;
+    }
+    printf("astar found a path of length: %d\n", path_length);
+
+    /* print maze */
+    maze_print(m, false);
+    maze_output_ppm(m, "out.ppm");
+
+    maze_cleanup(m);
+    return 0;
+}
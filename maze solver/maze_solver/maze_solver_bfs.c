@@ -12,75 +12,101 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 
+#include "bfs_bidirectional.h"
+#include "bfs_bitparallel.h"
+#include "bfs_external.h"
+#include "bfs_parallel.h"
+#include "distance.h"
 #include "maze.h"
-#include "queue.h"
+#include "metrics.h"
+#include "prune.h"
+#include "solver.h"
+
+/* Queue of maze indices for bfs_solve(). */
+#define TYPED_QUEUE cell_queue
+#define TYPED_QUEUE_ITEM uint32_t
+#include "queue_typed.h"
 
-#define NOT_FOUND -1
-#define ERROR -2
 #define VALID_MOVES 4
-#define SIZE 5000
-#define MULT 400
-#define MAX 501
+#define MAX_THREADS 256
+#define DIRS_PER_BYTE 4
+
+/* Measurements of the run for --stats=json, or NULL if they are not collected. */
+static struct metrics *run_stats = NULL;
+
+/* Returns the direction (index into m_offsets) of the move into cell 'idx'. */
+static int get_dir(const uint8_t *dirs, int idx) {
+    return (dirs[idx / DIRS_PER_BYTE] >> (idx % DIRS_PER_BYTE * 2)) & 3;
+}
+
+/* Stores the direction 'dir' of the move into cell 'idx', which must not be set yet. */
+static void set_dir(uint8_t *dirs, int idx, int dir) {
+    dirs[idx / DIRS_PER_BYTE] |= (uint8_t) (dir << (idx % DIRS_PER_BYTE * 2));
+}
 
 /**
  * looks for all adjacent nodes that are possible as next move and add it to the the queue.
+ * A node is marked TO_VISIT as soon as it is queued, so every cell enters the queue at most once
+ * and keeps the direction it was first discovered from.
  * 
  * m: maze.
  * r: index of row.
  * c: index of column.
  * q: queue
- * p: array of predecessor node
- * pred: index of predecessor node
+ * dirs: packed array with the direction of the move into every discovered node.
  * 
  * Returns:
- * adds all adjacent nodes into the queue
+ * 0 if all adjacent nodes were added to the queue, 1 if the queue could not grow.
 */
-void node_search(struct maze *m, int r, int c, struct queue *q, int *p, int pred) {
+int node_search(struct maze *m, int r, int c, struct cell_queue *q, uint8_t *dirs) {
+    unsigned open = maze_open_neighbors(m, r, c);
 
     for (int i = 0; i < VALID_MOVES; i++) {
+        if (!((open >> i) & 1)) continue;
+
         int r_new = r + m_offsets[i][0];
         int c_new = c + m_offsets[i][1];
-        int idx = maze_index(m, r_new, c_new);
 
-        if (maze_valid_move(m, r_new, c_new) && maze_get(m, r_new, c_new) != VISITED
-            && maze_get(m, r_new, c_new) != WALL) {
+        if (!maze_valid_move(m, r_new, c_new)) continue;
 
-            queue_push(q, maze_index(m, r_new, c_new));
-            p[idx] = pred;
-            
-            if (!maze_at_destination(m, r, c)) {
-                maze_set(m, r_new, c_new, TO_VISIT);
-            }    
-        }
+        char val = maze_get(m, r_new, c_new);
+        if (val == VISITED || val == TO_VISIT) continue;
+
+        int idx = maze_index(m, r_new, c_new);
+        if (cell_queue_push(q, (uint32_t) idx)) return 1;
+
+        set_dir(dirs, idx, i);
+        maze_set(m, r_new, c_new, TO_VISIT);
     }
+
+    return 0;
 }
 
 /**
- * Looks for the shortest path. It starts at destination and regenates shortest path by looking at
- * the predecessor of the current node, while drawing it.
+ * Looks for the shortest path. It starts at destination and regenates shortest path by stepping
+ * back against the direction each node was reached from, while drawing it.
  * 
  * m: maze
- * r: row index
- * c: column index
- * p: prev array
- * pred: index of predecessor node
+ * r: row index of the destination
+ * c: column index of the destination
+ * dirs: packed direction array
  * 
  * Returns:
  * Total length of the shortest path.
 */
-int shortest_path(struct maze *m, int r, int c, int *p, int pred) {
+int shortest_path(struct maze *m, int r, int c, const uint8_t *dirs) {
     int len = 0;
 
     while (!maze_at_start(m, r, c)) {
-        r = maze_row(m, pred);
-        c = maze_col(m, pred);
-        pred = p[pred];
+        int dir = get_dir(dirs, maze_index(m, r, c));
 
-        if (!maze_at_start(m, r, c)) {
-            maze_set(m, r, c, PATH);
-            len++;
-        }
+        maze_set(m, r, c, PATH);
+        len++;
+        r -= m_offsets[dir][0];
+        c -= m_offsets[dir][1];
     }
 
     return len;
@@ -88,60 +114,256 @@ int shortest_path(struct maze *m, int r, int c, int *p, int pred) {
 
 
 /* Solves the maze m.
+ * The queue holds 32-bit cell indices and grows with the frontier, and only the 2-bit direction
+ * into every cell is kept for the path, four cells per byte, instead of a full predecessor index.
  * Returns the length of the path if a path is found.
  * Returns NOT_FOUND if no path is found and ERROR if an error occured.
  */
 int bfs_solve(struct maze *m) {
-    struct queue *q = queue_init(SIZE);
-    size_t arr_size = (size_t) (maze_size(m) * MULT);
-    
-    if (maze_size(m) == MAX) arr_size = (size_t) (maze_size(m) * maze_size(m));
-    
-    int prev[arr_size], r = 0, c = 0, idx = 0;
+    size_t cells = maze_cells(m);
+    size_t dir_bytes = (cells + DIRS_PER_BYTE - 1) / DIRS_PER_BYTE;
+    struct cell_queue q;
+    int q_err = cell_queue_init(&q, (size_t) maze_size(m) * 4);
+    uint8_t *dirs = calloc(dir_bytes, sizeof(uint8_t));
+    int r = 0, c = 0, level = 0;
+    size_t level_left = 1;
+    int len = NOT_FOUND;
 
-    for (size_t i = 0; i < arr_size; i++) {
-        prev[i] = -1;
+    if (q_err || dirs == NULL) {
+        cell_queue_cleanup(&q);
+        free(dirs);
+        return ERROR;
     }
-    
-    maze_start(m, &r, &c);
-    queue_push(q, maze_index(m, r, c));
 
-    while (!queue_empty(q)) {
-        if (queue_size(q) > SIZE) {
-            queue_cleanup(q);
-            return ERROR;
-        }
+    maze_start(m, &r, &c);
+    cell_queue_push(&q, (uint32_t) maze_index(m, r, c));
+    maze_set(m, r, c, TO_VISIT);
 
-        int peek = queue_peek(q);
+    while (!cell_queue_empty(&q)) {
+        size_t frontier = cell_queue_size(&q);
+        int peek = (int) cell_queue_pop(&q);
         r = maze_row(m, peek);
         c = maze_col(m, peek);
-
-        queue_pop(q);
-        node_search(m, r, c, q, prev, peek);
         maze_set(m, r, c, VISITED);
 
+        /* When the last cell of a level is taken, the queue holds exactly the next level. */
+        if (run_stats) {
+            if (level_left == 0) {
+                level++;
+                level_left = frontier;
+            }
+            level_left--;
+            if (metrics_expand(run_stats, level, frontier)) {
+                len = ERROR;
+                break;
+            }
+        }
+
         if (maze_at_destination(m, r, c)) {
-            queue_cleanup(q);
-            return shortest_path(m, r, c, prev, peek);
+            double t0 = metrics_now_ms();
+            len = shortest_path(m, r, c, dirs);
+            if (run_stats) {
+                run_stats->path_ms = metrics_now_ms() - t0;
+            }
+            break;
         }
 
-        idx++;
+        if (node_search(m, r, c, &q, dirs)) {
+            len = ERROR;
+            break;
+        }
+    }
+
+    if (run_stats) {
+        run_stats->bytes = cell_queue_bytes(&q) + dir_bytes;
+    }
+#ifdef CONTAINER_STATS
+    cell_queue_stats(&q);
+#endif
+    cell_queue_cleanup(&q);
+    free(dirs);
+    return len;
+}
+
+/* Number of threads for --threads. */
+static int n_threads = 1;
+
+/* Solves the maze m with the multithreaded BFS on 'n_threads' threads. */
+static int bfs_threads_solve(struct maze *m) {
+    return bfs_parallel_solve(m, n_threads, run_stats);
+}
+
+/* Solves the maze m with the bit-parallel BFS. */
+static int bitparallel_solve(struct maze *m) {
+    return bfs_bitparallel_solve(m, run_stats);
+}
+
+/* Solves the maze m with the bidirectional BFS. */
+static int bidirectional_solve(struct maze *m) {
+    return bfs_bidirectional_solve(m, run_stats);
+}
+
+/**
+ * Computes the distances from the start to every cell, writes them to the given files and prints
+ * the distance to the destination.
+ *
+ * m: maze.
+ * dist_file: file for the binary distances, or NULL.
+ * heat_file: file for the ppm heatmap, or NULL.
+ *
+ * Returns:
+ * 0 if successful, 1 if an error occured or the destination cannot be reached. The files are
+ * written in both cases.
+*/
+static int distance_field(const struct maze *m, const char *dist_file, const char *heat_file) {
+    int r = 0, c = 0;
+
+    double t0 = metrics_now_ms();
+    struct distances *d = distances_compute(m, run_stats);
+    if (!d) {
+        printf("bfs failed\n");
+        return 1;
+    }
+    maze_destination(m, &r, &c);
+    int len = distances_get(d, r, c);
+    if (run_stats) {
+        run_stats->search_ms = metrics_now_ms() - t0;
+        metrics_print_json(run_stats, stderr, "bfs_distances", len);
     }
 
-    queue_cleanup(q);
-    return NOT_FOUND;
+    if ((dist_file && distances_save(d, dist_file)) || (heat_file && distances_output_ppm(d, m, heat_file))) {
+        distances_cleanup(d);
+        return 1;
+    }
+
+    printf("bfs reached %ld cells up to a distance of %u\n", distances_reached(d), distances_max(d));
+    if (len == NOT_FOUND) {
+        printf("no path found from start to destination\n");
+    } else {
+        printf("bfs found a path of length: %d\n", len);
+    }
+
+    distances_cleanup(d);
+    return len == NOT_FOUND;
 }
 
-int main(void) {
+/**
+ * Solves the maze in 'filename' with the external-memory BFS and prints the length of the path.
+ *
+ * filename: text or binary maze file.
+ *
+ * Returns:
+ * 0 if a path is found, 1 otherwise.
+*/
+static int external_solve(const char *filename) {
+    double t0 = metrics_now_ms();
+    int path_length = bfs_external_solve(filename, run_stats);
+    if (run_stats && path_length != ERROR) {
+        run_stats->search_ms = metrics_now_ms() - t0 - run_stats->load_ms;
+        metrics_print_json(run_stats, stderr, "bfs_external", path_length);
+    }
+    if (path_length == ERROR) {
+        printf("bfs failed\n");
+        return 1;
+    } else if (path_length == NOT_FOUND) {
+        printf("no path found from start to destination\n");
+        return 1;
+    }
+    printf("bfs found a path of length: %d\n", path_length);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    int (*solve)(struct maze *) = bfs_solve;
+    const char *name = "bfs";
+    bool prune = false;
+    const char *dist_file = NULL;
+    const char *heat_file = NULL;
+    const char *external = NULL;
+    bool json = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--prune") == 0) {
+            prune = true;
+        } else if (strcmp(argv[i], "--stats=json") == 0) {
+            json = true;
+        } else if (strcmp(argv[i], "--bitparallel") == 0) {
+            solve = bitparallel_solve;
+            name = "bfs_bitparallel";
+        } else if (strcmp(argv[i], "--bidirectional") == 0) {
+            solve = bidirectional_solve;
+            name = "bfs_bidirectional";
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            char *end;
+            long n = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || n < 1 || n > MAX_THREADS) {
+                fprintf(stderr, "--threads expects a number from 1 to %d\n", MAX_THREADS);
+                return 1;
+            }
+            n_threads = (int) n;
+            solve = bfs_threads_solve;
+            name = "bfs_threads";
+        } else if (strcmp(argv[i], "--distances") == 0 && i + 1 < argc) {
+            dist_file = argv[++i];
+        } else if (strcmp(argv[i], "--heatmap") == 0 && i + 1 < argc) {
+            heat_file = argv[++i];
+        } else if (strcmp(argv[i], "--external") == 0 && i + 1 < argc) {
+            external = argv[++i];
+        } else {
+            solve = NULL;
+            break;
+        }
+    }
+    /* The distance field and the external search are searches of their own, the path options do
+     * not apply to them. */
+    if (!solve || ((dist_file || heat_file || external) && (prune || solve != bfs_solve))
+        || (external && (dist_file || heat_file))) {
+        fprintf(stderr, "usage: %s [--prune] [--bitparallel | --bidirectional | --threads N] < maze\n"
+                "       %s [--distances FILE] [--heatmap FILE] < maze\n"
+                "       %s --external maze\n"
+                "--stats=json may be added to each of them to measure the search\n",
+                argv[0], argv[0], argv[0]);
+        return 1;
+    }
+
+    struct metrics stats;
+    metrics_init(&stats);
+    run_stats = json ? &stats : NULL;
+
+    /* The maze may not fit in memory, so it is never read as a whole. */
+    if (external) {
+        int err = external_solve(external);
+        metrics_cleanup(&stats);
+        return err;
+    }
+
+    double t0 = metrics_now_ms();
+
     /* read maze */
     struct maze *m = maze_read();
     if (!m) {
         printf("Error reading maze\n");
         return 1;
     }
+    stats.load_ms = metrics_now_ms() - t0;
+    stats.size = maze_size(m);
+
+    /* distance field */
+    if (dist_file || heat_file) {
+        int err = distance_field(m, dist_file, heat_file);
+        metrics_cleanup(&stats);
+        maze_cleanup(m);
+        return err;
+    }
 
     /* solve maze */
-    int path_length = bfs_solve(m);
+    t0 = metrics_now_ms();
+    int path_length = prune ? prune_solve(m, solve) : solve(m);
+    stats.search_ms = metrics_now_ms() - t0 - stats.path_ms;
+    if (json && path_length != ERROR) {
+        metrics_print_json(&stats, stderr, name, path_length);
+    }
+    metrics_cleanup(&stats);
     if (path_length == ERROR) {
         printf("bfs failed\n");
         maze_cleanup(m);
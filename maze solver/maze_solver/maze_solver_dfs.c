@@ -13,154 +13,182 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 
 #include "maze.h"
+#include "metrics.h"
+#include "prune.h"
+#include "solver.h"
 #include "stack.h"
 
-#define NOT_FOUND -1
-#define ERROR -2
 #define VALID_MOVES 4
-#define SIZE 100000
-#define MULT 200
+#define WORD_BITS 64
+
+/* Measurements of the run for --stats=json, or NULL if they are not collected. */
+static struct metrics *run_stats = NULL;
 
 /**
- * Searches if the index is in the visited array.
+ * Checks the bit of 'idx' in the visited bitmap.
  * 
- * n: size of array visited
- * a: the array visited
- * i: index of the array
- * m: current index of the maze
+ * visited: bitmap with one bit per maze cell.
+ * idx: index of the cell in the maze.
  * 
- * Returns true if the array contains the current index, otherwise returns false. 
+ * Returns true if the cell is marked as visited, otherwise returns false. 
 */
-bool is_visited (int n, int *a, int m) {
-    for (int i = 0; i < n; i++) {
-        if (a[i] == m) return true; 
-    }
-
-    return false;
+static bool is_visited(const uint64_t *visited, int idx) {
+    return (visited[idx / WORD_BITS] >> (idx % WORD_BITS)) & 1;
 }
 
 /**
- * Looks for adjacent nodes for valid next move, if move is found and the node is -1(meaning empty)
- * the value will be put in node. Otherwise place a ',' as possible alternative route.
- * 
- * m: maze.
- * r: index of row.
- * c: index of column.
- * a: array of visited.
- * n: size of array of visited.
+ * Sets the bit of 'idx' in the visited bitmap.
  * 
- * Returns:
- * If succesful, returns the node with index of next move, otherwise return -1.
+ * visited: bitmap with one bit per maze cell.
+ * idx: index of the cell in the maze.
 */
-int node_search(struct maze *m, int r, int c, int *a, int n) {
-    int node = -1;
-
-    for (int i = 0; i < VALID_MOVES; i++) {
-        int r_new = r + m_offsets[i][0];
-        int c_new = c + m_offsets[i][1];
-        int idx = maze_index(m, r_new, c_new);
-
-        if (maze_valid_move(m, r_new, c_new) && !is_visited(n, a, idx) && maze_get(m, r_new, c_new) != WALL) {
-            if (node == -1) {
-                node = idx;
-            } else {
-                maze_set(m, r_new, c_new, TO_VISIT);
-            }
-        }
-    }
-
-    return node;
+static void set_visited(uint64_t *visited, int idx) {
+    visited[idx / WORD_BITS] |= (uint64_t) 1 << (idx % WORD_BITS);
 }
 
-
 /**
- * Counts the length of the taken path. It searches the whole mazes and counts up each time it
- * encounters a path 'X'.
+ * Looks for the next valid move from the cell on top of the stack. The neighbors are tried in the
+ * order of m_offsets, starting at the direction cursor of the top frame, so every neighbor of a
+ * cell is looked at only once over the whole search.
  * 
- * m: maze
- * n: size of maze
- * i: row index
- * j: column index
+ * m: maze.
+ * s: stack, the top item is the current cell.
+ * visited: bitmap of visited cells.
  * 
  * Returns:
- * the length of the path.
+ * If succesful, returns the index of the next move, otherwise returns -1 when every direction of
+ * the current cell has been tried.
 */
-int count_path(struct maze *m) {
-    int path_len = 0;
+int node_search(struct maze *m, struct stack *s, const uint64_t *visited) {
+    int cur = stack_peek(s);
+    int r = maze_row(m, cur);
+    int c = maze_col(m, cur);
+    unsigned open = maze_open_neighbors(m, r, c);
+    int dir;
+
+    while ((dir = stack_next_cursor(s)) < VALID_MOVES && dir >= 0) {
+        if (!((open >> dir) & 1)) continue;
+
+        int r_new = r + m_offsets[dir][0];
+        int c_new = c + m_offsets[dir][1];
+        int idx = maze_index(m, r_new, c_new);
 
-    for (int i = 0; i < maze_size(m); i++) {
-        for (int j = 0; j < maze_size(m); j++) {
-            if (maze_get(m, i, j) == PATH) {
-                path_len++;
-            }
+        if (maze_valid_move(m, r_new, c_new) && !is_visited(visited, idx)) {
+            return idx;
         }
     }
-    return path_len;
+
+    return -1;
 }
 
 /* Solves the maze m.
+ * Every cell is pushed at most once and every direction of a cell is tried once, so the search
+ * runs in time and memory linear in the number of cells. The cells on the stack form the
+ * current path, which means its length is simply the stack size, and the path is already marked
+ * when the destination is reached, so no reconstruction time is measured for --stats=json.
  * Returns the length of the path if a path is found.
  * Returns NOT_FOUND if no path is found and ERROR if an error occured.
  */
 int dfs_solve(struct maze *m) {
-    struct stack *s = stack_init(SIZE); 
-    int arr_size = maze_size(m) * MULT;
-    int visited[arr_size]; 
-    int r = 0, c = 0, idx = 0;
-
-    for (int i = 0; i < arr_size; i++) {
-        visited[i] = -1;
+    size_t cells = maze_cells(m);
+    size_t visited_words = (cells + WORD_BITS - 1) / WORD_BITS;
+    struct stack *s = stack_init((size_t) maze_size(m) * 4);
+    uint64_t *visited = calloc(visited_words, sizeof(uint64_t));
+    int r = 0, c = 0;
+    int len = NOT_FOUND;
+
+    if (s == NULL || visited == NULL) {
+        stack_cleanup(s);
+        free(visited);
+        return ERROR;
     }
-    
 
     maze_start(m, &r, &c);
-    stack_push(s, maze_index(m, r, c)); 
+    stack_push(s, maze_index(m, r, c));
+    set_visited(visited, maze_index(m, r, c));
+    maze_set(m, r, c, PATH);
+    if (run_stats && metrics_expand(run_stats, 0, 1)) {
+        len = ERROR;
+    }
 
-    while (!stack_empty(s)) {
-        if (stack_size(s) > SIZE) {
-            stack_cleanup(s); 
-            return ERROR; 
-        }
-        
-        c = maze_col(m, stack_peek(s)); 
+    while (!stack_empty(s) && len == NOT_FOUND) {
+        c = maze_col(m, stack_peek(s));
         r = maze_row(m, stack_peek(s));
 
         if (maze_at_destination(m, r, c)) {
-            stack_cleanup(s); 
-            return count_path(m);
+            len = (int) stack_size(s) - 1;
+            break;
         }
 
-        maze_set(m, r, c, PATH);
-
-        visited[idx] = stack_peek(s);
-        int next_move = node_search(m, r, c, visited, arr_size);
+        int next_move = node_search(m, s, visited);
 
         if (next_move == -1) {
             maze_set(m, r, c, VISITED);
             stack_pop(s);
         } else {
-            stack_push(s, next_move);
-        }
+            if (stack_push(s, next_move)) {
+                len = ERROR;
+                break;
+            }
+            set_visited(visited, next_move);
+            maze_set(m, maze_row(m, next_move), maze_col(m, next_move), PATH);
 
-        idx++;
+            /* A cell is expanded when it is pushed, at its depth on the stack. */
+            if (run_stats && metrics_expand(run_stats, (int) stack_size(s) - 1, stack_size(s))) {
+                len = ERROR;
+            }
+        }
     }
 
-    stack_cleanup(s); 
-    return NOT_FOUND; 
+    if (run_stats) {
+        run_stats->bytes = stack_bytes(s) + visited_words * sizeof(uint64_t);
+    }
+    stack_cleanup(s);
+    free(visited);
+    return len;
 }
 
-int main(void) {
+int main(int argc, char *argv[]) {
+    bool prune = false;
+    bool json = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--prune") == 0) {
+            prune = true;
+        } else if (strcmp(argv[i], "--stats=json") == 0) {
+            json = true;
+        } else {
+            fprintf(stderr, "usage: %s [--prune] [--stats=json] < maze\n", argv[0]);
+            return 1;
+        }
+    }
+
+    struct metrics stats;
+    metrics_init(&stats);
+    run_stats = json ? &stats : NULL;
+    double t0 = metrics_now_ms();
+
     /* read maze */
     struct maze *m = maze_read();
     if (!m) {
         printf("Error reading maze\n");
         return 1;
     }
+    stats.load_ms = metrics_now_ms() - t0;
+    stats.size = maze_size(m);
 
     /* solve maze */
-    int path_length = dfs_solve(m);
+    t0 = metrics_now_ms();
+    int path_length = prune ? prune_solve(m, dfs_solve) : dfs_solve(m);
+    stats.search_ms = metrics_now_ms() - t0;
+    if (json && path_length != ERROR) {
+        metrics_print_json(&stats, stderr, "dfs", path_length);
+    }
+    metrics_cleanup(&stats);
     if (path_length == ERROR) {
         printf("dfs failed\n");
         maze_cleanup(m);
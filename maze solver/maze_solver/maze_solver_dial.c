@@ -0,0 +1,266 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program solves mazes whose floor cells have a cost, the digits 2 to 9 in the maze file,
+ * with Dial's algorithm. It is Dijkstra's algorithm, but because every move costs at most C,
+ * the largest cell cost, all cells waiting to be expanded have a distance from d up to d + C
+ * while the cells at distance d are expanded. C + 1 buckets, one queue per distance modulo
+ * C + 1, are therefore enough to hold them, and the next cell is taken from the bucket of the
+ * current distance instead of from a heap. Every push and pop is constant time and every bucket
+ * is looked at once per distance, so a path of cost L is found in O(V + L) time on a maze of V
+ * cells, without a single comparison of keys.
+ *
+ * A cell that is reached again at a lower distance is pushed again; its old entry is skipped
+ * when its bucket comes up. Mazes without costs are solved in the same order as the BFS solver.
+ * The distances are ints: maze_read() refuses mazes in which a path could cost more.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "maze.h"
+#include "metrics.h"
+#include "queue.h"
+#include "solver.h"
+
+#define VALID_MOVES 4
+
+/* Measurements of the run for --stats=json, or NULL if they are not collected. */
+static struct metrics *run_stats = NULL;
+
+struct dial {
+    struct queue **bucket;
+    int n_buckets;
+    int *g;
+    unsigned char *dir;
+    long pending;
+};
+
+/**
+ * Frees the buckets and arrays of the search.
+ *
+ * s: search state.
+*/
+static void dial_cleanup(struct dial *s) {
+    if (s->bucket) {
+        for (int i = 0; i < s->n_buckets; i++) {
+            queue_cleanup(s->bucket[i]);
+        }
+    }
+    free(s->bucket);
+    free(s->g);
+    free(s->dir);
+}
+
+/**
+ * Allocates one bucket per distance modulo the largest cost plus one, and the arrays of the search.
+ *
+ * s: search state.
+ * m: maze.
+ *
+ * Returns:
+ * 0 if successful, 1 if memory could not be allocated.
+*/
+static int dial_init(struct dial *s, const struct maze *m) {
+    size_t cells = maze_cells(m);
+
+    s->n_buckets = maze_max_cost(m) + 1;
+    s->bucket = calloc((size_t) s->n_buckets, sizeof(struct queue *));
+    s->g = calloc(cells, sizeof(int));
+    s->dir = malloc(cells);
+    s->pending = 0;
+    if (!s->bucket || !s->g || !s->dir) {
+        dial_cleanup(s);
+        return 1;
+    }
+    for (int i = 0; i < s->n_buckets; i++) {
+        s->bucket[i] = queue_init((size_t) maze_size(m));
+        if (!s->bucket[i]) {
+            dial_cleanup(s);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Adds cell 'idx' at distance 'dist' to its bucket.
+ *
+ * s: search state.
+ * idx: index of the cell.
+ * dist: cost of the path to the cell.
+ *
+ * Returns:
+ * 0 if successful, 1 if the bucket could not grow.
+*/
+static int push_cell(struct dial *s, int idx, int dist) {
+    if (queue_push(s->bucket[dist % s->n_buckets], idx)) return 1;
+    s->g[idx] = dist + 1;
+    s->pending++;
+    return 0;
+}
+
+/**
+ * Looks for all adjacent nodes that are not expanded yet, and adds them to the bucket of their
+ * distance when this is the cheapest way to reach them so far.
+ *
+ * m: maze.
+ * s: search state.
+ * r: row of the current cell.
+ * c: column of the current cell.
+ * dist: cost of the path to the current cell.
+ *
+ * Returns:
+ * 0 if successful, 1 if a bucket could not grow.
+*/
+static int node_search(struct maze *m, struct dial *s, int r, int c, int dist) {
+    unsigned open = maze_open_neighbors(m, r, c);
+
+    for (int i = 0; i < VALID_MOVES; i++) {
+        if (!((open >> i) & 1)) continue;
+
+        int r_new = r + m_offsets[i][0];
+        int c_new = c + m_offsets[i][1];
+        if (!maze_valid_move(m, r_new, c_new) || maze_get(m, r_new, c_new) == VISITED) continue;
+
+        int idx = maze_index(m, r_new, c_new);
+        int dist_new = dist + maze_cost(m, r_new, c_new);
+        if (s->g[idx] != 0 && s->g[idx] - 1 <= dist_new) continue;
+
+        if (push_cell(s, idx, dist_new)) return 1;
+        s->dir[idx] = (unsigned char) i;
+        maze_set(m, r_new, c_new, TO_VISIT);
+    }
+
+    return 0;
+}
+
+/**
+ * Draws the path by stepping back against the direction every cell was reached from, from the
+ * destination to the start.
+ *
+ * m: maze.
+ * dir: direction of the move into every reached cell.
+ * r: row of the destination.
+ * c: column of the destination.
+*/
+static void shortest_path(struct maze *m, const unsigned char *dir, int r, int c) {
+    while (!maze_at_start(m, r, c)) {
+        int d = dir[maze_index(m, r, c)];
+
+        maze_set(m, r, c, PATH);
+        r -= m_offsets[d][0];
+        c -= m_offsets[d][1];
+    }
+}
+
+/* Solves the maze m.
+ * Returns the cost of the path if a path is found.
+ * Returns NOT_FOUND if no path is found and ERROR if an error occured.
+ */
+int dial_solve(struct maze *m) {
+    struct dial s;
+    int r = 0, c = 0;
+    int len = NOT_FOUND;
+
+    if (dial_init(&s, m)) {
+        return ERROR;
+    }
+
+    maze_start(m, &r, &c);
+    if (push_cell(&s, maze_index(m, r, c), 0)) {
+        dial_cleanup(&s);
+        return ERROR;
+    }
+
+    for (int dist = 0; s.pending > 0 && len == NOT_FOUND; dist++) {
+        struct queue *q = s.bucket[dist % s.n_buckets];
+
+        while (!queue_empty(q) && len == NOT_FOUND) {
+            int cur = queue_pop(q);
+            s.pending--;
+            /* Skip entries of cells that were reached cheaper after they were pushed. */
+            if (s.g[cur] - 1 != dist) continue;
+
+            r = maze_row(m, cur);
+            c = maze_col(m, cur);
+            maze_set(m, r, c, VISITED);
+
+            if (run_stats && metrics_expand(run_stats, dist, (size_t) s.pending + 1)) {
+                len = ERROR;
+            } else if (maze_at_destination(m, r, c)) {
+                double t0 = metrics_now_ms();
+                shortest_path(m, s.dir, r, c);
+                if (run_stats) {
+                    run_stats->path_ms = metrics_now_ms() - t0;
+                }
+                len = dist;
+            } else if (node_search(m, &s, r, c, dist)) {
+                len = ERROR;
+            }
+        }
+    }
+
+    if (run_stats) {
+        run_stats->bytes = sizeof(struct queue *) * (size_t) s.n_buckets + (sizeof(int) + 1) * maze_cells(m);
+        for (int i = 0; i < s.n_buckets; i++) {
+            run_stats->bytes += queue_bytes(s.bucket[i]);
+        }
+    }
+    dial_cleanup(&s);
+    return len;
+}
+
+int main(int argc, char *argv[]) {
+    bool json = argc == 2 && strcmp(argv[1], "--stats=json") == 0;
+
+    if (argc > 1 && !json) {
+        fprintf(stderr, "usage: %s [--stats=json] < maze\n", argv[0]);
+        return 1;
+    }
+
+    struct metrics stats;
+    metrics_init(&stats);
+    run_stats = json ? &stats : NULL;
+    double t0 = metrics_now_ms();
+
+    /* read maze */
+    struct maze *m = maze_read();
+    if (!m) {
+        printf("Error reading maze\n");
+        return 1;
+    }
+    stats.load_ms = metrics_now_ms() - t0;
+    stats.size = maze_size(m);
+
+    /* solve maze */
+    t0 = metrics_now_ms();
+    int path_length = dial_solve(m);
+    stats.search_ms = metrics_now_ms() - t0 - stats.path_ms;
+    if (json && path_length != ERROR) {
+        metrics_print_json(&stats, stderr, "dial", path_length);
+    }
+    metrics_cleanup(&stats);
+    if (path_length == ERROR) {
+        printf("dial failed\n");
+        maze_cleanup(m);
+        return 1;
+    } else if (path_length == NOT_FOUND) {
+        printf("no path found from start to destination\n");
+        maze_cleanup(m);
+        return 1;
+    }
+    printf("dial found a path of length: %d\n", path_length);
+
+    /* print maze */
+    maze_print(m, false);
+    maze_output_ppm(m, "out.ppm");
+
+    maze_cleanup(m);
+    return 0;
+}
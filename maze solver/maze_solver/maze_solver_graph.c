@@ -0,0 +1,179 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program solves a maze on its junction graph. The corridors of the maze are contracted into
+ * weighted edges between junctions and dead ends, so the search only has to look at the cells
+ * where a choice can be made instead of at every open cell. The program reads the maze, builds
+ * the graph, runs Dijkstra's algorithm on it, paints the path back into the maze and prints the
+ * results.
+ *
+ * With --hpa SIZE the maze is cut into clusters of SIZE by SIZE cells instead, and the path is
+ * found on the hierarchical abstraction of hpa.c and refined cluster by cluster. Such a path may
+ * be a few moves longer than the shortest path.
+ *
+ * With --stats=json the measurements of the search are printed to stderr as well. Building the
+ * graph or the abstraction counts as part of the search.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "graph.h"
+#include "hpa.h"
+#include "maze.h"
+#include "metrics.h"
+#include "solver.h"
+
+#define MAX_CLUSTER_SIZE 1024
+
+/* Measurements of the run for --stats=json, or NULL if they are not collected. */
+static struct metrics *run_stats = NULL;
+
+/**
+ * Solves the maze on its junction graph and marks the path.
+ *
+ * m: maze.
+ *
+ * Returns:
+ * the length of the path if a path is found.
+ * NOT_FOUND if no path is found and ERROR if an error occured.
+*/
+static int graph_solve(struct maze *m) {
+    int r = 0, c = 0, dest_r = 0, dest_c = 0;
+
+    struct graph *g = graph_build(m);
+    if (!g) {
+        return ERROR;
+    }
+    struct graph_search *s = graph_search_init(g);
+    if (!s) {
+        graph_cleanup(g);
+        return ERROR;
+    }
+
+    maze_start(m, &r, &c);
+    maze_destination(m, &dest_r, &dest_c);
+
+    graph_search_measure(s, run_stats);
+    int len = graph_query(s, maze_index(m, r, c), maze_index(m, dest_r, dest_c));
+    if (len >= 0) {
+        double t0 = metrics_now_ms();
+        graph_paint(s, m);
+        if (run_stats) {
+            run_stats->path_ms = metrics_now_ms() - t0;
+        }
+    }
+
+    graph_search_cleanup(s);
+    graph_cleanup(g);
+    return len;
+}
+
+/**
+ * Solves the maze on its cluster abstraction and marks the refined path.
+ *
+ * m: maze.
+ * cluster_size: number of cells of a side of a cluster.
+ *
+ * Returns:
+ * the length of the path if a path is found.
+ * NOT_FOUND if no path is found and ERROR if an error occured.
+*/
+static int hpa_solve(struct maze *m, int cluster_size) {
+    int r = 0, c = 0, dest_r = 0, dest_c = 0;
+
+    struct hpa *h = hpa_build(m, cluster_size);
+    if (!h) {
+        return ERROR;
+    }
+    struct hpa_search *s = hpa_search_init(h);
+    if (!s) {
+        hpa_cleanup(h);
+        return ERROR;
+    }
+
+    maze_start(m, &r, &c);
+    maze_destination(m, &dest_r, &dest_c);
+
+    hpa_search_measure(s, run_stats);
+    int len = hpa_query(s, maze_index(m, r, c), maze_index(m, dest_r, dest_c));
+    if (len >= 0) {
+        double t0 = metrics_now_ms();
+        hpa_paint(s, m);
+        if (run_stats) {
+            run_stats->path_ms = metrics_now_ms() - t0;
+        }
+    }
+
+    hpa_search_cleanup(s);
+    hpa_cleanup(h);
+    return len;
+}
+
+int main(int argc, char *argv[]) {
+    int cluster_size = 0;
+    bool json = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--hpa") == 0 && i + 1 < argc) {
+            char *end;
+            long n = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || n < 1 || n > MAX_CLUSTER_SIZE) {
+                fprintf(stderr, "--hpa expects a number from 1 to %d\n", MAX_CLUSTER_SIZE);
+                return 1;
+            }
+            cluster_size = (int) n;
+        } else if (strcmp(argv[i], "--stats=json") == 0) {
+            json = true;
+        } else {
+            fprintf(stderr, "usage: %s [--hpa SIZE] [--stats=json] < maze\n", argv[0]);
+            return 1;
+        }
+    }
+
+    struct metrics stats;
+    metrics_init(&stats);
+    run_stats = json ? &stats : NULL;
+    double t0 = metrics_now_ms();
+
+    /* read maze */
+    struct maze *m = maze_read();
+    if (!m) {
+        printf("Error reading maze\n");
+        return 1;
+    }
+    stats.load_ms = metrics_now_ms() - t0;
+    stats.size = maze_size(m);
+
+    /* solve maze */
+    const char *name = cluster_size ? "hpa" : "graph";
+    t0 = metrics_now_ms();
+    int path_length = cluster_size ? hpa_solve(m, cluster_size) : graph_solve(m);
+    stats.search_ms = metrics_now_ms() - t0 - stats.path_ms;
+    if (json && path_length != ERROR) {
+        metrics_print_json(&stats, stderr, name, path_length);
+    }
+    metrics_cleanup(&stats);
+    if (path_length == ERROR) {
+        printf("%s failed\n", name);
+        maze_cleanup(m);
+        return 1;
+    } else if (path_length == NOT_FOUND) {
+        printf("no path found from start to destination\n");
+        maze_cleanup(m);
+        return 1;
+    }
+    printf("%s found a path of length: %d\n", name, path_length);
+
+    /* print maze */
+    maze_print(m, false);
+    maze_output_ppm(m, "out.ppm");
+
+    maze_cleanup(m);
+    return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program collects the measurements of a solver run for --stats=json: the time spent
+ * reading the maze, searching and reconstructing the path, the number of expanded cells, the
+ * largest frontier, the bytes allocated by the search and a histogram of the expanded cells per
+ * level. For a breadth-first search the cells of one level are exactly the frontier when the
+ * level starts, so the histogram shows how the frontier grows and shrinks. A level-synchronous
+ * search counts a whole level at once. The histogram doubles in size when a deeper level is
+ * reached.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "metrics.h"
+#include "solver.h"
+
+#define INIT_LEVELS 64
+
+void metrics_init(struct metrics *mt) {
+    memset(mt, 0, sizeof(struct metrics));
+}
+
+void metrics_cleanup(struct metrics *mt) {
+    free(mt->levels);
+    mt->levels = NULL;
+}
+
+double metrics_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e3 + (double) ts.tv_nsec / 1e6;
+}
+
+/**
+ * Grows the level histogram until it has room for 'level'. The new levels start at zero.
+ *
+ * mt: measurements.
+ * level: deepest level to make room for.
+ *
+ * Returns:
+ * 0 if successful, 1 if the memory could not be allocated.
+*/
+static int grow_levels(struct metrics *mt, size_t level) {
+    size_t new_cap = mt->capacity ? mt->capacity : INIT_LEVELS;
+
+    while (new_cap <= level) {
+        if (new_cap > SIZE_MAX / (2 * sizeof(long))) return 1;
+        new_cap *= 2;
+    }
+
+    long *levels = realloc(mt->levels, sizeof(long) * new_cap);
+    if (levels == NULL) return 1;
+
+    memset(levels + mt->capacity, 0, sizeof(long) * (new_cap - mt->capacity));
+    mt->levels = levels;
+    mt->capacity = new_cap;
+    return 0;
+}
+
+int metrics_expand_level(struct metrics *mt, int level, size_t cells, size_t frontier) {
+    size_t l = (size_t) level;
+
+    if (level < 0 || (l >= mt->capacity && grow_levels(mt, l))) return 1;
+
+    mt->levels[l] += (long) cells;
+    if (l >= mt->n_levels) {
+        mt->n_levels = l + 1;
+    }
+    mt->expanded += (long) cells;
+    if (frontier > mt->peak_frontier) {
+        mt->peak_frontier = frontier;
+    }
+    return 0;
+}
+
+int metrics_expand(struct metrics *mt, int level, size_t frontier) {
+    return metrics_expand_level(mt, level, 1, frontier);
+}
+
+void metrics_print_json(const struct metrics *mt, FILE *f, const char *solver, int path_length) {
+    fprintf(f, "{\"solver\": \"%s\", \"size\": %d, \"cells\": %zu, ", solver, mt->size,
+            (size_t) mt->size * (size_t) mt->size);
+    if (path_length == NOT_FOUND) {
+        fprintf(f, "\"path_length\": null, ");
+    } else {
+        fprintf(f, "\"path_length\": %d, ", path_length);
+    }
+    fprintf(f, "\"load_ms\": %.3f, \"search_ms\": %.3f, \"reconstruction_ms\": %.3f, ",
+            mt->load_ms, mt->search_ms, mt->path_ms);
+    fprintf(f, "\"cells_expanded\": %ld, \"peak_frontier\": %zu, \"bytes_allocated\": %zu, ",
+            mt->expanded, mt->peak_frontier, mt->bytes);
+    fprintf(f, "\"expanded_per_level\": [");
+    for (size_t i = 0; i < mt->n_levels; i++) {
+        fprintf(f, i ? ", %ld" : "%ld", mt->levels[i]);
+    }
+    fprintf(f, "]}\n");
+}
@@ -0,0 +1,47 @@
+#ifndef _METRICS_H_
+#define _METRICS_H_
+
+#include <stddef.h>
+#include <stdio.h>
+
+/* Measurements of one solver run, printed by --stats=json. The solver fills
+ * in the counters and the reconstruction time, main() the other times and
+ * the size of the maze, unless the solver reads the maze itself. */
+struct metrics {
+    int size;
+    double load_ms;
+    double search_ms;
+    double path_ms;
+    long expanded;
+    size_t peak_frontier;
+    size_t bytes;
+    long *levels;
+    size_t n_levels;
+    size_t capacity;
+};
+
+/* Sets all measurements of 'mt' to zero. */
+void metrics_init(struct metrics *mt);
+
+/* Frees the level histogram of 'mt'. */
+void metrics_cleanup(struct metrics *mt);
+
+/* Returns the time of the monotonic clock in milliseconds. */
+double metrics_now_ms(void);
+
+/* Counts an expanded cell at 'level', its distance from the start (or its
+ * depth on the stack of a depth-first search), while 'frontier' cells are
+ * waiting to be expanded.
+ * Returns 0 if successful, 1 if the level histogram could not grow. */
+int metrics_expand(struct metrics *mt, int level, size_t frontier);
+
+/* Counts 'cells' expanded cells at 'level' at once, for searches that expand
+ * a whole level together, while 'frontier' cells are waiting to be expanded.
+ * Returns 0 if successful, 1 if the level histogram could not grow. */
+int metrics_expand_level(struct metrics *mt, int level, size_t cells, size_t frontier);
+
+/* Writes the measurements of a run of 'solver' as one line of JSON to 'f'.
+ * 'path_length' is the result of the solver; NOT_FOUND is written as null. */
+void metrics_print_json(const struct metrics *mt, FILE *f, const char *solver, int path_length);
+
+#endif
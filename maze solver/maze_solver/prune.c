@@ -0,0 +1,110 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program fills the dead ends of a maze before it is searched. A dead end can never be part
+ * of a path between two other cells, so it is turned into a wall. That can turn the cell next to
+ * it into a dead end as well, which is why those cells are put on a worklist instead of scanning
+ * the whole grid again. Every cell is filled at most once and only looks at its four neighbors,
+ * so the pre-pass is linear in the size of the maze. On a maze with a single path only that path
+ * stays open, and the solver that runs afterwards has almost nothing left to explore.
+*/
+
+#include <stdlib.h>
+
+#include "prune.h"
+
+/**
+ * Counts the open neighbors of a cell that are valid moves.
+ *
+ * m: maze.
+ * r: row of the cell.
+ * c: column of the cell.
+ *
+ * Returns:
+ * the number of open neighbors.
+*/
+static int open_degree(const struct maze *m, int r, int c) {
+    unsigned open = maze_open_neighbors(m, r, c);
+    int degree = 0;
+
+    for (int i = 0; i < N_MOVES; i++) {
+        if (((open >> i) & 1) && maze_valid_move(m, r + m_offsets[i][0], c + m_offsets[i][1])) {
+            degree++;
+        }
+    }
+    return degree;
+}
+
+/* Returns true if (r, c) is an open cell that may be filled once it is a dead end. */
+static bool fillable(const struct maze *m, int r, int c) {
+    return maze_valid_move(m, r, c) && !maze_is_wall(m, r, c) && !maze_at_start(m, r, c)
+           && !maze_at_destination(m, r, c);
+}
+
+int prune_dead_ends(struct maze *m, int **filled) {
+    int n = maze_size(m);
+    int n_work = 0, n_filled = 0;
+
+    /* Every cell is put on the worklist at most once: either at the start, or when its number
+     * of open neighbors drops to one. */
+    int *work = malloc(sizeof(int) * (size_t) n * (size_t) n);
+    *filled = malloc(sizeof(int) * (size_t) n * (size_t) n);
+    if (!work || !*filled) {
+        free(work);
+        free(*filled);
+        *filled = NULL;
+        return ERROR;
+    }
+
+    for (int r = 1; r < n - 1; r++) {
+        for (int c = 1; c < n - 1; c++) {
+            if (fillable(m, r, c) && open_degree(m, r, c) <= 1) {
+                work[n_work++] = maze_index(m, r, c);
+            }
+        }
+    }
+
+    while (n_work > 0) {
+        int idx = work[--n_work];
+        int r = maze_row(m, idx);
+        int c = maze_col(m, idx);
+
+        maze_set(m, r, c, WALL);
+        (*filled)[n_filled++] = idx;
+
+        for (int i = 0; i < N_MOVES; i++) {
+            int r_new = r + m_offsets[i][0];
+            int c_new = c + m_offsets[i][1];
+
+            if (fillable(m, r_new, c_new) && open_degree(m, r_new, c_new) == 1) {
+                work[n_work++] = maze_index(m, r_new, c_new);
+            }
+        }
+    }
+
+    free(work);
+    return n_filled;
+}
+
+void prune_reopen(struct maze *m, const int *filled, int n) {
+    for (int i = 0; i < n; i++) {
+        maze_set(m, maze_row(m, filled[i]), maze_col(m, filled[i]), FLOOR);
+    }
+}
+
+int prune_solve(struct maze *m, int (*solve)(struct maze *)) {
+    int *filled;
+    int n_filled = prune_dead_ends(m, &filled);
+    if (n_filled == ERROR) {
+        return ERROR;
+    }
+
+    int len = solve(m);
+
+    prune_reopen(m, filled, n_filled);
+    free(filled);
+    return len;
+}
@@ -0,0 +1,23 @@
+#ifndef _PRUNE_H_
+#define _PRUNE_H_
+
+#include "maze.h"
+#include "solver.h"
+
+/* Fills the dead ends of maze 'm' with WALL. A dead end is an open cell with
+ * at most one open neighbor that is not the start or the destination. Filling
+ * a dead end can turn its neighbor into one, so this repeats until none are
+ * left. The indices of the filled cells are stored in a new array in
+ * '*filled', which the caller has to free.
+ * Returns the number of filled cells or ERROR if an error occured. */
+int prune_dead_ends(struct maze *m, int **filled);
+
+/* Turns the 'n' cells in 'filled' back into FLOOR. */
+void prune_reopen(struct maze *m, const int *filled, int n);
+
+/* Fills the dead ends of 'm', runs 'solve' on the pruned maze and reopens the
+ * filled cells afterwards, so the maze is printed as it was read.
+ * Returns the return value of 'solve', or ERROR if an error occured. */
+int prune_solve(struct maze *m, int (*solve)(struct maze *));
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * Name: Nguyen Anh Le
+ * studentID: 15000370
+ * BsC Informatica
+ *
+ * Description:
+ * This program answers many shortest path queries on one maze. The maze itself is never written
+ * to: which cells a search has seen is kept in a separate array of epoch stamps. Every query
+ * starts a new epoch, so a cell only counts as seen if its stamp equals the current epoch and
+ * nothing has to be cleared between queries. Only when the epoch counter wraps around are the
+ * stamps cleared once. The queue is a plain array, because a breadth-first search puts every
+ * cell on it at most once.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "query.h"
+
+struct query {
+    const struct maze *m;
+    size_t capacity;
+    uint32_t epoch;
+    uint32_t *stamp;
+    int *queue;
+    long expanded;
+};
+
+struct query *query_init(const struct maze *m) {
+    struct query *q = calloc(1, sizeof(struct query));
+    if (!q) {
+        return NULL;
+    }
+
+    if (query_reset(q, m)) {
+        query_cleanup(q);
+        return NULL;
+    }
+    return q;
+}
+
+void query_cleanup(struct query *q) {
+    if (q == NULL) return;
+    free(q->stamp);
+    free(q->queue);
+    free(q);
+}
+
+int query_reset(struct query *q, const struct maze *m) {
+    size_t cells = maze_cells(m);
+
+    /* Stamps of an earlier maze are all older than the current epoch, so
+     * buffers that are large enough can be used as they are. */
+    if (cells > q->capacity) {
+        free(q->stamp);
+        free(q->queue);
+        q->capacity = 0;
+        q->epoch = 0;
+        q->stamp = calloc(cells, sizeof(uint32_t));
+        q->queue = malloc(cells * sizeof(int));
+        if (!q->stamp || !q->queue) {
+            return 1;
+        }
+        q->capacity = cells;
+    }
+
+    q->m = m;
+    q->expanded = 0;
+    return 0;
+}
+
+long query_expanded(const struct query *q) {
+    return q->expanded;
+}
+
+/* Starts a new epoch, which marks every cell as not seen. */
+static void next_epoch(struct query *q) {
+    q->epoch++;
+    if (q->epoch == 0) {
+        memset(q->stamp, 0, q->capacity * sizeof(uint32_t));
+        q->epoch = 1;
+    }
+}
+
+/* Returns true if the cell with index 'idx' may be entered. */
+static bool open_cell(const struct maze *m, int idx) {
+    int r = maze_row(m, idx);
+    int c = maze_col(m, idx);
+    return maze_valid_move(m, r, c) && !maze_is_wall(m, r, c);
+}
+
+int query_length(struct query *q, int start, int dest) {
+    const struct maze *m = q->m;
+
+    q->expanded = 0;
+    if (!open_cell(m, start) || !open_cell(m, dest)) {
+        return NOT_FOUND;
+    }
+    if (start == dest) {
+        return 0;
+    }
+
+    next_epoch(q);
+    q->stamp[start] = q->epoch;
+    q->queue[0] = start;
+
+    /* The queue is handled one level at a time, so the level is the distance. */
+    int head = 0, tail = 1;
+    for (int level = 1; head < tail; level++) {
+        int level_end = tail;
+
+        for (; head < level_end; head++) {
+            int cur = q->queue[head];
+            int r = maze_row(m, cur);
+            int c = maze_col(m, cur);
+            unsigned open = maze_open_neighbors(m, r, c);
+
+            for (int i = 0; i < N_MOVES; i++) {
+                int r_new = r + m_offsets[i][0];
+                int c_new = c + m_offsets[i][1];
+                if (!((open >> i) & 1) || !maze_valid_move(m, r_new, c_new)) continue;
+
+                int next = maze_index(m, r_new, c_new);
+                if (q->stamp[next] == q->epoch) continue;
+                if (next == dest) {
+                    q->expanded = head + 1;
+                    return level;
+                }
+                q->stamp[next] = q->epoch;
+                q->queue[tail++] = next;
+            }
+        }
+    }
+
+    q->expanded = head;
+    return NOT_FOUND;
+}
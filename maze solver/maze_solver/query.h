@@ -0,0 +1,34 @@
+#ifndef _QUERY_H_
+#define _QUERY_H_
+
+#include "maze.h"
+#include "solver.h"
+
+/* Handle to the scratch buffers for shortest path queries on one maze */
+struct query;
+
+/* Returns scratch buffers for repeated breadth-first searches on maze 'm', or
+ * NULL if an error occured. The maze is only read, so any number of query
+ * handles can share it. The maze must not change while the handle is used. */
+struct query *query_init(const struct maze *m);
+
+/* Frees the scratch buffers. */
+void query_cleanup(struct query *q);
+
+/* Moves the scratch buffers over to maze 'm', growing them if 'm' is larger
+ * than any maze they were used for before. This lets one handle solve a
+ * series of mazes without allocating new buffers for every one of them.
+ * Returns 0 if successful, 1 if memory could not be allocated. */
+int query_reset(struct query *q, const struct maze *m);
+
+/* Returns the number of cells expanded by the last query. */
+long query_expanded(const struct query *q);
+
+/* Finds the length of the shortest path between the cells with maze indices
+ * 'start' and 'dest'. The buffers are not cleared between queries: every
+ * query has its own epoch and a cell only counts as seen if it carries the
+ * current one.
+ * Returns the length of the path if a path is found, NOT_FOUND otherwise. */
+int query_length(struct query *q, int start, int dest);
+
+#endif
@@ -9,22 +9,68 @@
  * It supports operations like enqueue (inserting an element at the rear) 
  * and dequeue (removing an element from the front). The program defines the queue structure and 
  * functions to work with it.
+ *
+ * The queue is a ring buffer whose capacity is always a power of two, so wrapping around is a
+ * bitmask instead of a modulo. When the buffer is full it doubles in size, which means a push
+ * only fails if memory runs out.
+ *
+ * Push, pop and the other operations a solver calls for every cell are defined inline in
+ * queue.h, and only keep statistics when compiled with CONTAINER_STATS. This file holds the
+ * slow paths and the external definitions of the inline functions.
 */
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "queue.h"
 
-struct queue {
-    int front;
-    int rear;
-    size_t capacity;
-    int *data;
-    int pop_count;
-    int push_count;
-    size_t max_elem;
-};
+/**
+ * Rounds the requested capacity up to the next power of two.
+ *
+ * capacity: requested number of elements.
+ *
+ * Returns:
+ * the smallest power of two that is at least 'capacity' (and at least 1), or 0 on overflow.
+*/
+static size_t round_capacity(size_t capacity) {
+    size_t cap = 1;
+
+    while (cap < capacity) {
+        if (cap > SIZE_MAX / 2) return 0;
+        cap *= 2;
+    }
+
+    return cap;
+}
+
+/**
+ * Doubles the capacity of the ring buffer. The elements that wrapped around to the start of the
+ * old buffer are moved behind the old end, so the queue stays one contiguous run modulo the new
+ * capacity.
+ *
+ * q: queue
+ *
+ * Returns:
+ * 0 if successful, 1 if the memory could not be allocated.
+*/
+int queue_grow(struct queue *q) {
+    if (q->capacity > SIZE_MAX / (2 * sizeof(int))) return 1;
+
+    size_t new_cap = q->capacity * 2;
+    int *data = realloc(q->data, sizeof(int) * new_cap);
+    if (data == NULL) return 1;
+
+    /* Elements [0, wrapped) belong behind the old end of the buffer. */
+    size_t wrapped = q->front + q->count > q->capacity ? q->front + q->count - q->capacity : 0;
+    memcpy(data + q->capacity, data, sizeof(int) * wrapped);
+
+    q->data = data;
+    q->capacity = new_cap;
+
+    return 0;
+}
 
 struct queue *queue_init(size_t capacity) {
     struct queue* q = malloc(sizeof(struct queue));
@@ -32,15 +78,20 @@ struct queue *queue_init(size_t capacity) {
         return NULL;
     }
 
-    q->data = malloc(sizeof(int) * capacity);
+    q->capacity = round_capacity(capacity);
+    if (q->capacity == 0 || q->capacity > SIZE_MAX / sizeof(int)) {
+        free(q);
+        return NULL;
+    }
+
+    q->data = malloc(sizeof(int) * q->capacity);
     if (q->data == NULL) {
         free(q);
         return NULL;
     }
 
-    q->capacity = capacity;
-    q->front = -1;
-    q->rear = -1;
+    q->front = 0;
+    q->count = 0;
     q->pop_count = 0;
     q->push_count = 0;
     q->max_elem = 0;
@@ -59,64 +110,14 @@ void queue_stats(const struct queue *q) {
     fprintf(stderr, "stats %d %d %ld\n", q->push_count, q->pop_count, q->max_elem);
 }
 
-int queue_push(struct queue *q, int e) {
-    //check if queue is full
-    if ((q == NULL) || (q->rear + 1) % (int)q->capacity == q->front) {
-        return 1;
-    } else if (q->front == -1 && q->rear == -1) {
-        q->front = 0;
-        q->rear = 0;
-        q->data[q->rear] = e;
-    } else {
-        q->rear = (q->rear + 1) % (int)q->capacity;
-        q->data[q->rear] = e;
-    }
-    q->push_count++;
-
-    if (queue_size(q) > q->max_elem) {
-        q->max_elem = queue_size(q);
-    }
-
-    return 0;
-}
-
-int queue_pop(struct queue *q) {
-    if (q == NULL || queue_empty(q)) return -1; 
-    
-    int item;
-    if (q->front == q->rear) {
-        item = q->data[q->front];
-        q->front = -1;
-        q->rear = -1;
-    } else {
-        item = q->data[q->front];
-        q->front = (q->front + 1) % (int) q->capacity;
-    }
-    q->pop_count++;
-
-    return item;
-}
-
-int queue_peek(const struct queue *q) {
-    if (q == NULL || q->front == -1) return -1;
-    return q->data[q->front];
-}
-
-int queue_empty(const struct queue *q) {
-    if (q == NULL) {
-        return -1;
-    } else if (q->front == -1 && q->rear == -1) {
-        return 1;
-    } else {
-        return 0;
-    }
-}
-
-size_t queue_size(const struct queue *q) {
+size_t queue_bytes(const struct queue *q) {
     if (q == NULL) return 0;
-
-    if (q->rear >= q->front)
-        return (size_t)(q->rear - q->front) + 1;
-
-    return (size_t)(q->front - q->rear) + 1;
+    return sizeof(struct queue) + sizeof(int) * q->capacity;
 }
+
+/* External definitions of the inline functions in queue.h, for callers that do not inline them. */
+extern inline int queue_push(struct queue *q, int e);
+extern inline int queue_pop(struct queue *q);
+extern inline int queue_peek(const struct queue *q);
+extern inline int queue_empty(const struct queue *q);
+extern inline size_t queue_size(const struct queue *q);
@@ -1,35 +1,90 @@
 /* Do not edit this file. */
+#ifndef _QUEUE_H_
+#define _QUEUE_H_
+
 #include <stddef.h>
 
-/* Handle to queue */
-struct queue;
+/* Ring buffer queue. The struct is defined here so push, pop and the other
+ * small operations below can be inlined into the loop of a solver; use the
+ * functions instead of the fields. */
+struct queue {
+    size_t front;
+    size_t count;
+    size_t capacity;
+    int *data;
+    int pop_count;
+    int push_count;
+    size_t max_elem;
+};
 
-/* Return a pointer to a queue data structure with a maximum capacity of
- * 'capacity' if successful, otherwise return NULL. */
+/* Return a pointer to a queue data structure with an initial capacity of
+ * 'capacity' if successful, otherwise return NULL. The capacity is rounded up
+ * to a power of two and doubles whenever the queue is full. */
 struct queue *queue_init(size_t capacity);
 
 /* Cleanup queue. */
 void queue_cleanup(struct queue *q);
 
 /* Print queue statistics to stderr.
- * The format is: 'stats' num_of_pushes num_of_pops max_elements */
+ * The format is: 'stats' num_of_pushes num_of_pops max_elements
+ * The counts are only kept when compiled with -DCONTAINER_STATS (make
+ * STATS=1), otherwise they stay 0. */
 void queue_stats(const struct queue *q);
 
-/* Push item the end of the queue.
+/* Return the number of bytes allocated by the queue, or 0 if 'q' is NULL. */
+size_t queue_bytes(const struct queue *q);
+
+/* Double the capacity of the queue. Called by queue_push() when it is full.
  * Return 0 if successful, 1 otherwise. */
-int queue_push(struct queue *q, int e);
+int queue_grow(struct queue *q);
+
+/* Push item the end of the queue, growing the queue if it is full.
+ * Return 0 if successful, 1 otherwise. */
+inline int queue_push(struct queue *q, int e) {
+    if (q == NULL) return 1;
+    if (q->count == q->capacity && queue_grow(q)) return 1;
+    q->data[(q->front + q->count) & (q->capacity - 1)] = e;
+    q->count++;
+#ifdef CONTAINER_STATS
+    q->push_count++;
+    if (q->count > q->max_elem) {
+        q->max_elem = q->count;
+    }
+#endif
+    return 0;
+}
 
 /* Remove the first item from queue and return it.
  * Return the first item if successful, -1 otherwise. */
-int queue_pop(struct queue *q);
+inline int queue_pop(struct queue *q) {
+    if (q == NULL || q->count == 0) return -1;
+    int item = q->data[q->front];
+    q->front = (q->front + 1) & (q->capacity - 1);
+    q->count--;
+#ifdef CONTAINER_STATS
+    q->pop_count++;
+#endif
+    return item;
+}
 
 /* Return the first item from queue. Leave queue unchanged.
  * Return the first item if successful, -1 otherwise. */
-int queue_peek(const struct queue *q);
+inline int queue_peek(const struct queue *q) {
+    if (q == NULL || q->count == 0) return -1;
+    return q->data[q->front];
+}
 
 /* Return 1 if queue is empty, 0 if the queue contains any elements and
  * return -1 if the operation fails. */
-int queue_empty(const struct queue *q);
+inline int queue_empty(const struct queue *q) {
+    if (q == NULL) return -1;
+    return q->count == 0;
+}
 
 /* Return the number of elements stored in the queue. */
-size_t queue_size(const struct queue *q);
+inline size_t queue_size(const struct queue *q) {
+    if (q == NULL) return 0;
+    return q->count;
+}
+
+#endif
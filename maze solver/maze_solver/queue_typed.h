@@ -0,0 +1,137 @@
+/* Queue whose item type is chosen at compile time. This file is a template:
+ * define TYPED_QUEUE to the name of the queue and TYPED_QUEUE_ITEM to the
+ * type of its items before including it, for example
+ *
+ *     #define TYPED_QUEUE cell_queue
+ *     #define TYPED_QUEUE_ITEM uint32_t
+ *     #include "queue_typed.h"
+ *
+ * defines struct cell_queue and cell_queue_init(), cell_queue_cleanup(),
+ * cell_queue_push(), cell_queue_pop(), cell_queue_empty(), cell_queue_size(),
+ * cell_queue_bytes() and cell_queue_stats(). It works like queue.h, but every function is static
+ * inline and the queue lives in the caller's variable instead of on the heap,
+ * so a solver loop only touches the ring buffer itself. The file may be
+ * included again to define another queue. */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(TYPED_QUEUE) || !defined(TYPED_QUEUE_ITEM)
+#error "define TYPED_QUEUE and TYPED_QUEUE_ITEM before including queue_typed.h"
+#endif
+
+#define TQ_PASTE(a, b) a##b
+#define TQ_NAME(a, b) TQ_PASTE(a, b)
+#define TQ_FN(name) TQ_NAME(TYPED_QUEUE, TQ_PASTE(_, name))
+
+struct TYPED_QUEUE {
+    size_t front;
+    size_t count;
+    size_t capacity;
+    TYPED_QUEUE_ITEM *data;
+#ifdef CONTAINER_STATS
+    int pop_count;
+    int push_count;
+    size_t max_elem;
+#endif
+};
+
+/* Initializes 'q' with a capacity of at least 'capacity', rounded up to a
+ * power of two. Return 0 if successful, 1 otherwise. */
+static inline int TQ_FN(init)(struct TYPED_QUEUE *q, size_t capacity) {
+    memset(q, 0, sizeof(*q));
+    q->capacity = 1;
+    while (q->capacity < capacity) {
+        if (q->capacity > SIZE_MAX / (2 * sizeof(TYPED_QUEUE_ITEM))) return 1;
+        q->capacity *= 2;
+    }
+
+    q->data = malloc(sizeof(TYPED_QUEUE_ITEM) * q->capacity);
+    return q->data == NULL;
+}
+
+/* Frees the buffer of 'q'. */
+static inline void TQ_FN(cleanup)(struct TYPED_QUEUE *q) {
+    free(q->data);
+    q->data = NULL;
+}
+
+/* Doubles the capacity of 'q', moving the items that wrapped around behind
+ * the old end. Return 0 if successful, 1 otherwise. */
+static inline int TQ_FN(grow)(struct TYPED_QUEUE *q) {
+    if (q->capacity > SIZE_MAX / (2 * sizeof(TYPED_QUEUE_ITEM))) return 1;
+
+    size_t new_cap = q->capacity * 2;
+    TYPED_QUEUE_ITEM *data = realloc(q->data, sizeof(TYPED_QUEUE_ITEM) * new_cap);
+    if (data == NULL) return 1;
+
+    size_t wrapped = q->front + q->count > q->capacity ? q->front + q->count - q->capacity : 0;
+    memcpy(data + q->capacity, data, sizeof(TYPED_QUEUE_ITEM) * wrapped);
+    q->data = data;
+    q->capacity = new_cap;
+    return 0;
+}
+
+/* Pushes 'e' to the end of 'q', growing it if it is full.
+ * Return 0 if successful, 1 otherwise. */
+static inline int TQ_FN(push)(struct TYPED_QUEUE *q, TYPED_QUEUE_ITEM e) {
+    if (q->count == q->capacity && TQ_FN(grow)(q)) return 1;
+    q->data[(q->front + q->count) & (q->capacity - 1)] = e;
+    q->count++;
+#ifdef CONTAINER_STATS
+    q->push_count++;
+    if (q->count > q->max_elem) {
+        q->max_elem = q->count;
+    }
+#endif
+    return 0;
+}
+
+/* Removes the first item from 'q', which must not be empty, and returns it. */
+static inline TYPED_QUEUE_ITEM TQ_FN(pop)(struct TYPED_QUEUE *q) {
+    TYPED_QUEUE_ITEM item = q->data[q->front];
+    q->front = (q->front + 1) & (q->capacity - 1);
+    q->count--;
+#ifdef CONTAINER_STATS
+    q->pop_count++;
+#endif
+    return item;
+}
+
+/* Returns true if 'q' is empty. */
+static inline bool TQ_FN(empty)(const struct TYPED_QUEUE *q) {
+    return q->count == 0;
+}
+
+/* Returns the number of items in 'q'. */
+static inline size_t TQ_FN(size)(const struct TYPED_QUEUE *q) {
+    return q->count;
+}
+
+/* Returns the number of bytes allocated by 'q'. */
+static inline size_t TQ_FN(bytes)(const struct TYPED_QUEUE *q) {
+    return sizeof(TYPED_QUEUE_ITEM) * q->capacity;
+}
+
+/* Prints the statistics of 'q' to stderr in the format of queue_stats():
+ * 'stats' num_of_pushes num_of_pops max_elements
+ * The counts are only kept when compiled with -DCONTAINER_STATS (make
+ * STATS=1), otherwise they are printed as 0. */
+static inline void TQ_FN(stats)(const struct TYPED_QUEUE *q) {
+#ifdef CONTAINER_STATS
+    fprintf(stderr, "stats %d %d %zu\n", q->push_count, q->pop_count, q->max_elem);
+#else
+    (void) q;
+    fprintf(stderr, "stats 0 0 0\n");
+#endif
+}
+
+#undef TQ_FN
+#undef TQ_NAME
+#undef TQ_PASTE
+#undef TYPED_QUEUE
+#undef TYPED_QUEUE_ITEM
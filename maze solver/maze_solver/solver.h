@@ -0,0 +1,9 @@
+/* Return values shared by the maze solvers. A solver returns the length of the
+ * path it found, or one of the values below. */
+#ifndef _SOLVER_H_
+#define _SOLVER_H_
+
+#define NOT_FOUND -1
+#define ERROR -2
+
+#endif
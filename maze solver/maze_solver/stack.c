@@ -8,21 +8,43 @@
  * data structure that follows the Last-In-First-Out (LIFO) principle. It supports operations like 
  * push (adding an element to the top) and pop (removing an element from the top). The program 
  * defines the stack structure and functions to work with it.
+ *
+ * Every frame on the stack also carries a small cursor next to its item. A depth-first search
+ * uses it to remember which neighbor of a cell it tries next, so resuming a cell after
+ * backtracking does not rescan the neighbors that were already tried. The stack doubles in size
+ * when it is full.
+ *
+ * Push, pop and the other operations a solver calls for every cell are defined inline in
+ * stack.h, and only keep statistics when compiled with CONTAINER_STATS. This file holds the
+ * slow paths and the external definitions of the inline functions.
 */
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 #include "stack.h"
 
-struct stack {
-    int top;
-    size_t capacity;
-    int *data;
-    int pop_count;
-    int push_count;
-    size_t max_elem;
-};
+/**
+ * Doubles the capacity of the stack.
+ *
+ * s: stack
+ *
+ * Returns:
+ * 0 if successful, 1 if the memory could not be allocated.
+*/
+int stack_grow(struct stack *s) {
+    size_t new_cap = s->capacity ? s->capacity * 2 : 1;
+    if (new_cap > SIZE_MAX / sizeof(struct frame) || new_cap > INT32_MAX) return 1;
+
+    struct frame *data = realloc(s->data, sizeof(struct frame) * new_cap);
+    if (data == NULL) return 1;
+
+    s->data = data;
+    s->capacity = new_cap;
+
+    return 0;
+}
 
 struct stack *stack_init(size_t capacity) {
     struct stack* s = malloc(sizeof(struct stack));
@@ -30,7 +52,13 @@ struct stack *stack_init(size_t capacity) {
         return NULL;
     }
 
-    s->data = malloc(sizeof(int) * capacity);
+    if (capacity == 0) capacity = 1;
+    if (capacity > SIZE_MAX / sizeof(struct frame)) {
+        free(s);
+        return NULL;
+    }
+
+    s->data = malloc(sizeof(struct frame) * capacity);
     if (s->data == NULL) {
         free(s);
         return NULL;
@@ -56,44 +84,15 @@ void stack_stats(const struct stack *s) {
     fprintf(stderr, "stats %d %d %ld\n", s->push_count, s->pop_count, s->max_elem);
 }
 
-int stack_push(struct stack *s, int c) {
-    if (s == NULL || s->top == (int)s->capacity - 1) return 1;
-    s->top++;
-    s->data[s->top] = c;
-    s->push_count++;
-
-    if (stack_size(s) > s->max_elem) {
-        s->max_elem = stack_size(s);
-    }
-
-    return 0;
-}
-
-int stack_pop(struct stack *s) {
-    if (s == NULL || s->top == -1) return -1;
-    int item = s->data[s->top];
-    s->top--;
-    s->pop_count++;
-
-    return item;
+size_t stack_bytes(const struct stack *s) {
+    if (s == NULL) return 0;
+    return sizeof(struct stack) + sizeof(struct frame) * s->capacity;
 }
 
-int stack_peek(const struct stack *s) {
-    if (s == NULL || s->top == -1) return -1;
-    return s->data[s->top];
-}
-
-int stack_empty(const struct stack *s) {
-    if (s == NULL) {
-        return -1;
-    } else if (s->top == -1) {
-        return 1;
-    } else {
-        return 0;
-    }
-}
-
-size_t stack_size(const struct stack *s) {
-    if (s == NULL) return 1;
-    return (size_t)s->top + 1;
-}
+/* External definitions of the inline functions in stack.h, for callers that do not inline them. */
+extern inline int stack_push(struct stack *s, int e);
+extern inline int stack_pop(struct stack *s);
+extern inline int stack_peek(const struct stack *s);
+extern inline int stack_next_cursor(struct stack *s);
+extern inline int stack_empty(const struct stack *s);
+extern inline size_t stack_size(const struct stack *s);
@@ -1,35 +1,101 @@
 /* Do not edit this file. */
+#ifndef _STACK_H_
+#define _STACK_H_
+
 #include <stddef.h>
 
-/* Handle to stack */
-struct stack;
+/* Stack with a cursor in every frame. The struct is defined here so push,
+ * pop and the other small operations below can be inlined into the loop of
+ * a solver; use the functions instead of the fields. */
+struct frame {
+    int item;
+    int cursor;
+};
+
+struct stack {
+    int top;
+    size_t capacity;
+    struct frame *data;
+    int pop_count;
+    int push_count;
+    size_t max_elem;
+};
 
-/* Return a pointer to a stack data structure with a maximum capacity of
- * 'capacity' if successful, otherwise return NULL. */
+/* Return a pointer to a stack data structure with an initial capacity of
+ * 'capacity' if successful, otherwise return NULL. The capacity doubles
+ * whenever the stack is full. */
 struct stack *stack_init(size_t capacity);
 
 /* Cleanup stack. */
 void stack_cleanup(struct stack *s);
 
 /* Print stack statistics to stderr.
- * The format is: 'stats' num_of_pushes num_of_pops max_elements */
+ * The format is: 'stats' num_of_pushes num_of_pops max_elements
+ * The counts are only kept when compiled with -DCONTAINER_STATS (make
+ * STATS=1), otherwise they stay 0. */
 void stack_stats(const struct stack *s);
 
-/* Push item onto the stack.
+/* Return the number of bytes allocated by the stack, or 0 if 's' is NULL. */
+size_t stack_bytes(const struct stack *s);
+
+/* Double the capacity of the stack. Called by stack_push() when it is full.
  * Return 0 if successful, 1 otherwise. */
-int stack_push(struct stack *s, int e);
+int stack_grow(struct stack *s);
+
+/* Push item onto the stack, growing the stack if it is full. The cursor of
+ * the new top frame starts at 0.
+ * Return 0 if successful, 1 otherwise. */
+inline int stack_push(struct stack *s, int e) {
+    if (s == NULL) return 1;
+    if ((size_t) (s->top + 1) == s->capacity && stack_grow(s)) return 1;
+    s->top++;
+    s->data[s->top].item = e;
+    s->data[s->top].cursor = 0;
+#ifdef CONTAINER_STATS
+    s->push_count++;
+    if ((size_t) s->top + 1 > s->max_elem) {
+        s->max_elem = (size_t) s->top + 1;
+    }
+#endif
+    return 0;
+}
 
 /* Pop item from stack and return it.
  * Return top item if successful, -1 otherwise. */
-int stack_pop(struct stack *s);
+inline int stack_pop(struct stack *s) {
+    if (s == NULL || s->top == -1) return -1;
+#ifdef CONTAINER_STATS
+    s->pop_count++;
+#endif
+    return s->data[s->top--].item;
+}
 
 /* Return top of item from stack. Leave stack unchanged.
  * Return top item if successful, -1 otherwise. */
-int stack_peek(const struct stack *s);
+inline int stack_peek(const struct stack *s) {
+    if (s == NULL || s->top == -1) return -1;
+    return s->data[s->top].item;
+}
+
+/* Return the cursor of the top frame and advance it by one. Solvers use it
+ * to remember the next neighbor direction to try for the item on top.
+ * Return the cursor if successful, -1 otherwise. */
+inline int stack_next_cursor(struct stack *s) {
+    if (s == NULL || s->top == -1) return -1;
+    return s->data[s->top].cursor++;
+}
 
 /* Return 1 if stack is empty, 0 if the stack contains any elements and
  * return -1 if the operation fails. */
-int stack_empty(const struct stack *s);
+inline int stack_empty(const struct stack *s) {
+    if (s == NULL) return -1;
+    return s->top == -1;
+}
 
 /* Return the number of elements stored in the stack. */
-size_t stack_size(const struct stack *s);
+inline size_t stack_size(const struct stack *s) {
+    if (s == NULL) return 1;
+    return (size_t) s->top + 1;
+}
+
+#endif